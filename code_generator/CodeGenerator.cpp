@@ -2,21 +2,136 @@
 // Created by M on 19.01.2025.
 //
 
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
 #include <utility>
 #include "CodeGenerator.h"
+#include "config.h"
+#include "runtime/Runtime.h"
 #include "util/panic.h"
+#include "util/SourceManager.h"
 
-void CodeGenerator::init_target_machine()
+#ifdef _LLVM_18
+static CodeGenOptLevel to_codegen_level(OptLevel level)
+{
+    switch (level)
+    {
+    case OptLevel::O0:
+        return CodeGenOptLevel::None;
+    case OptLevel::O1:
+        return CodeGenOptLevel::Less;
+    case OptLevel::O3:
+        return CodeGenOptLevel::Aggressive;
+    default:
+        return CodeGenOptLevel::Default;
+    }
+}
+#else
+static CodeGenOpt::Level to_codegen_level(OptLevel level)
 {
-    // initialize LLVM
+    switch (level)
+    {
+    case OptLevel::O0:
+        return CodeGenOpt::None;
+    case OptLevel::O1:
+        return CodeGenOpt::Less;
+    case OptLevel::O3:
+        return CodeGenOpt::Aggressive;
+    default:
+        return CodeGenOpt::Default;
+    }
+}
+#endif
+
+static CodeGenFileType to_file_type(OutputFileType type)
+{
+    switch (type)
+    {
+    case OutputFileType::AssemblyFile:
+#ifdef _LLVM_18
+        return CodeGenFileType::AssemblyFile;
+#else
+        return CodeGenFileType::CGFT_AssemblyFile;
+#endif
+    default:
+#ifdef _LLVM_18
+        return CodeGenFileType::ObjectFile;
+#else
+        return CodeGenFileType::CGFT_ObjectFile;
+#endif
+    }
+}
+
+// Initializes only the native target unless code for a different architecture is requested. Every target is initialized
+// at most once per process, code generators may be created concurrently.
+static void init_targets(const Triple &triple)
+{
+    static std::mutex mutex;
+    static bool native_initialized = false;
+    static bool all_initialized = false;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (all_initialized)
+    {
+        return;
+    }
+
+    if (triple.getArch() == Triple(sys::getProcessTriple()).getArch())
+    {
+        if (!native_initialized)
+        {
+            InitializeNativeTarget();
+            InitializeNativeTargetAsmParser();
+            InitializeNativeTargetAsmPrinter();
+            native_initialized = true;
+        }
+        return;
+    }
+
     InitializeAllTargetInfos();
     InitializeAllTargets();
     InitializeAllTargetMCs();
     InitializeAllAsmParsers();
     InitializeAllAsmPrinters();
-    // use default target triple of host
-    std::string triple = sys::getDefaultTargetTriple();
-    // set up target
+    all_initialized = true;
+}
+
+string CodeGenerator::target_triple(const CodeGenOptions &options)
+{
+    // use default target triple of host unless a specific one was requested
+    if (options.target_triple == "native")
+    {
+        return sys::getProcessTriple();
+    }
+    if (!options.target_triple.empty())
+    {
+        return Triple::normalize(options.target_triple);
+    }
+    return sys::getDefaultTargetTriple();
+}
+
+bool CodeGenerator::check_target(const CodeGenOptions &options, string &error)
+{
+    auto triple = target_triple(options);
+    init_targets(Triple(triple));
+    return TargetRegistry::lookupTarget(triple, error) != nullptr;
+}
+
+bool CodeGenerator::is_host_target(const CodeGenOptions &options)
+{
+    return options.target_triple.empty() || options.target_triple == "native" ||
+           Triple(target_triple(options)).getArch() == Triple(sys::getProcessTriple()).getArch();
+}
+
+void CodeGenerator::init_target_machine()
+{
+    auto triple = target_triple(options_);
+    init_targets(Triple(triple));
+
+    // set up target, the driver has checked that it is available
     std::string error;
     auto target = TargetRegistry::lookupTarget(triple, error);
     if (!target)
@@ -25,9 +140,36 @@ void CodeGenerator::init_target_machine()
     }
     else
     {
-        // set up target machine to match host
+        // set up target machine for the requested CPU and features
         std::string cpu = "generic";
+        if (options_.cpu == "native")
+        {
+            cpu = sys::getHostCPUName().str();
+        }
+        else if (!options_.cpu.empty())
+        {
+            cpu = options_.cpu;
+        }
+
         std::string features;
+        if (options_.features == "native")
+        {
+            SubtargetFeatures host_features;
+            StringMap<bool> feature_map;
+            if (sys::getHostCPUFeatures(feature_map))
+            {
+                for (auto &feature : feature_map)
+                {
+                    host_features.AddFeature(feature.first(), feature.second);
+                }
+            }
+            features = host_features.getString();
+        }
+        else
+        {
+            features = options_.features;
+        }
+
         TargetOptions opt;
 
 #ifdef _LLVM_LEGACY
@@ -35,15 +177,18 @@ void CodeGenerator::init_target_machine()
 #else
         auto model = std::optional<Reloc::Model>();
 #endif
+        if (options_.position_independent)
+        {
+            model = Reloc::PIC_;
+        }
 
-        target_ = target->createTargetMachine(triple, cpu, features, opt, model);
+        target_ = target->createTargetMachine(triple, cpu, features, opt, model, {}, to_codegen_level(options_.opt_level));
     }
 }
 
 void CodeGenerator::init_builder()
 {
-    init_target_machine();
-    builder_ = new IRBuilder<>(ctx_);
+    builder_ = new IRBuilder<>(*ctx_);
 
     if (!target_)
     {
@@ -51,15 +196,159 @@ void CodeGenerator::init_builder()
     }
 
     // set up LLVM module
-    module_ = new Module(filename_, ctx_);
+    module_ = new Module(filename_, *ctx_);
     module_->setDataLayout(target_->createDataLayout());
     module_->setTargetTriple(target_->getTargetTriple().getTriple());
 }
 
-CodeGenerator::CodeGenerator(string filename, OutputFileType output_type) : output_type_(output_type), filename_(std::move(filename))
+CodeGenerator::CodeGenerator(string filename, CodeGenOptions options) : ctx_(std::make_unique<LLVMContext>()), options_(std::move(options)), filename_(std::move(filename))
 {
     init_target_machine();
     init_builder();
+    if (options_.debug_info && module_)
+    {
+        init_debug_info();
+    }
+}
+
+void CodeGenerator::init_debug_info()
+{
+    if (Triple(module_->getTargetTriple()).isOSWindows())
+    {
+        module_->addModuleFlag(Module::Warning, "CodeView", 1);
+    }
+    else
+    {
+        module_->addModuleFlag(Module::Warning, "Dwarf Version", 4);
+    }
+    module_->addModuleFlag(Module::Warning, "Debug Info Version", DEBUG_METADATA_VERSION);
+
+    SmallString<128> path(filename_);
+    sys::fs::make_absolute(path);
+
+    di_builder_ = std::make_unique<DIBuilder>(*module_);
+    di_file_ = di_builder_->createFile(sys::path::filename(path), sys::path::parent_path(path));
+    // DWARF has no language code for Oberon, Modula-2 is its closest relative
+    di_unit_ = di_builder_->createCompileUnit(dwarf::DW_LANG_Modula2, di_file_, PROJECT_NAME " " PROJECT_VERSION,
+                                              options_.opt_level != OptLevel::O0, "", 0);
+    di_scopes_.push_back(di_file_);
+}
+
+DILocation *CodeGenerator::debug_location(FilePos pos)
+{
+    auto resolved = SourceManager::resolve(pos);
+    return DILocation::get(*ctx_, static_cast<unsigned>(std::max(resolved.lineNo, 0)), static_cast<unsigned>(std::max(resolved.charNo, 0)), di_scopes_.back());
+}
+
+void CodeGenerator::set_debug_location(FilePos pos)
+{
+    if (di_builder_)
+    {
+        builder_->SetCurrentDebugLocation(debug_location(pos));
+    }
+}
+
+// Lowers a TypeInfo to a debug type, named types are described as typedefs of their structure
+DIType *CodeGenerator::debug_type(const std::shared_ptr<TypeInfo> &type)
+{
+    auto cached = debug_types_.find(type.get());
+    if (cached != debug_types_.end())
+    {
+        return cached->second;
+    }
+
+    auto &layout = module_->getDataLayout();
+    DIType *di_type = nullptr;
+    switch (type->tag)
+    {
+    // Predefined types are registered by name when the module is entered
+    case INTEGER:
+        di_type = debug_type_names_[Symbol::integer_type()];
+        break;
+    case FLOAT:
+        di_type = debug_type_names_[Symbol::real_type()];
+        break;
+    case BOOLEAN:
+        di_type = debug_type_names_[Symbol::boolean_type()];
+        break;
+    case CHAR:
+        di_type = debug_type_names_[Symbol::char_type()];
+        break;
+    case STRING:
+        di_type = debug_type_names_[Symbol::string_type()];
+        break;
+    case ALIAS:
+    {
+        auto aliased = debug_type_names_.find(std::get<AliasTypeInfo>(type->extended_info.value()).aliased_type);
+        if (aliased != debug_type_names_.end())
+        {
+            di_type = di_builder_->createTypedef(aliased->second, type->name, di_file_, 0, di_unit_);
+        }
+        break;
+    }
+    case ARRAY:
+    {
+        auto &array = std::get<ArrayTypeInfo>(type->extended_info.value());
+        auto llvm_type = lookup_or_create_llvm_type(type);
+        auto subscripts = di_builder_->getOrCreateArray({di_builder_->getOrCreateSubrange(0, array.size)});
+        di_type = di_builder_->createArrayType(layout.getTypeAllocSizeInBits(llvm_type), layout.getABITypeAlign(llvm_type).value() * 8,
+                                               debug_type(array.element_type), subscripts);
+        break;
+    }
+    case RECORD:
+    {
+        auto &record = std::get<RecordTypeInfo>(type->extended_info.value());
+        auto llvm_type = cast<StructType>(lookup_or_create_llvm_type(type));
+        auto struct_layout = layout.getStructLayout(llvm_type);
+
+        std::vector<Metadata *> members;
+        for (auto &field : record.fields())
+        {
+            auto field_type = llvm_type->getElementType(field.index);
+            members.push_back(di_builder_->createMemberType(di_unit_, field.name.str(), di_file_, 0,
+                                                            layout.getTypeAllocSizeInBits(field_type), layout.getABITypeAlign(field_type).value() * 8,
+                                                            struct_layout->getElementOffsetInBits(field.index), DINode::FlagZero, debug_type(field.type)));
+        }
+        di_type = di_builder_->createStructType(di_unit_, "", di_file_, 0, struct_layout->getSizeInBits(), struct_layout->getAlignment().value() * 8,
+                                                DINode::FlagZero, nullptr, di_builder_->getOrCreateArray(members));
+        break;
+    }
+    case POINTER:
+    {
+        auto pointee = std::get<PointerTypeInfo>(type->extended_info.value()).pointee_type;
+        di_type = di_builder_->createPointerType(debug_type(pointee), layout.getPointerSizeInBits());
+        break;
+    }
+    default:
+        break;
+    }
+
+    debug_types_[type.get()] = di_type;
+    return di_type;
+}
+
+// Describes a declared variable, constant or parameter, the declared (not the traced) type is used so that aliases stay visible
+void CodeGenerator::describe_variable(IdentNode &ident, llvm::Value *storage, bool is_global)
+{
+    if (!di_builder_)
+    {
+        return;
+    }
+
+    auto type = ident.get_formal_type() ? ident.get_formal_type() : ident.get_actual_type();
+    auto di_type = debug_type(type);
+    auto line = static_cast<unsigned>(std::max(SourceManager::resolve(ident.pos()).lineNo, 0));
+
+    if (is_global)
+    {
+        auto expression = di_builder_->createGlobalVariableExpression(di_unit_, ident.get_value(), ident.get_value(), di_file_, line, di_type, true);
+        cast<GlobalVariable>(storage)->addDebugInfo(expression);
+    }
+    else
+    {
+        auto variable = di_builder_->createAutoVariable(di_scopes_.back(), ident.get_value(), di_file_, line, di_type, true);
+        di_builder_->insertDeclare(storage, variable, di_builder_->createExpression(), debug_location(ident.pos()), builder_->GetInsertBlock());
+    }
 }
 
 void CodeGenerator::visit(ExpressionNode &node)
@@ -142,6 +431,9 @@ void CodeGenerator::visit(BinaryExpressionNode &expr)
     expr.get_rhs()->accept(*this);
     llvm::Value *rhsValue = value_;
 
+    // CHAR values are ordered by their (unsigned) character codes
+    bool unsigned_order = lhsValue->getType()->isIntegerTy(8);
+
     switch (op)
     {
 
@@ -155,13 +447,27 @@ void CodeGenerator::visit(BinaryExpressionNode &expr)
     case SourceOperator::MULT:
         value_ = builder_->CreateMul(lhsValue, rhsValue, "mul");
         break;
+    // DIV rounds towards negative infinity and MOD takes the sign of the divisor, LLVM's division truncates instead:
+    // both are corrected by one step whenever the remainder is non-zero and its sign differs from the divisor's
     case SourceOperator::DIV:
-        value_ = builder_->CreateSDiv(lhsValue, rhsValue, "div");
-        break;
-
     case SourceOperator::MOD:
-        value_ = builder_->CreateSRem(lhsValue, rhsValue, "mod");
+    {
+        auto remainder = builder_->CreateSRem(lhsValue, rhsValue, "rem");
+        auto zero = llvm::ConstantInt::get(rhsValue->getType(), 0);
+        auto inexact = builder_->CreateICmpNE(remainder, zero, "inexact");
+        auto signs_differ = builder_->CreateICmpSLT(builder_->CreateXor(remainder, rhsValue, "sign"), zero, "signs_differ");
+        auto adjust = builder_->CreateAnd(inexact, signs_differ, "floor");
+        if (op == SourceOperator::DIV)
+        {
+            auto quotient = builder_->CreateSDiv(lhsValue, rhsValue, "quot");
+            value_ = builder_->CreateSub(quotient, builder_->CreateZExt(adjust, quotient->getType()), "div");
+        }
+        else
+        {
+            value_ = builder_->CreateAdd(remainder, builder_->CreateSelect(adjust, rhsValue, zero), "mod");
+        }
         break;
+    }
 
     case SourceOperator::FLOAT_DIV:
         value_ = builder_->CreateFDiv(lhsValue,rhsValue, "float_div");
@@ -177,16 +483,16 @@ void CodeGenerator::visit(BinaryExpressionNode &expr)
         value_ = builder_->CreateICmpNE(lhsValue, rhsValue, "neq");
         break;
     case SourceOperator::LT:
-        value_ = builder_->CreateICmpSLT(lhsValue, rhsValue, "lt");
+        value_ = unsigned_order ? builder_->CreateICmpULT(lhsValue, rhsValue, "lt") : builder_->CreateICmpSLT(lhsValue, rhsValue, "lt");
         break;
     case SourceOperator::LEQ:
-        value_ = builder_->CreateICmpSLE(lhsValue, rhsValue, "leq");
+        value_ = unsigned_order ? builder_->CreateICmpULE(lhsValue, rhsValue, "leq") : builder_->CreateICmpSLE(lhsValue, rhsValue, "leq");
         break;
     case SourceOperator::GT:
-        value_ = builder_->CreateICmpSGT(lhsValue, rhsValue, "gt");
+        value_ = unsigned_order ? builder_->CreateICmpUGT(lhsValue, rhsValue, "gt") : builder_->CreateICmpSGT(lhsValue, rhsValue, "gt");
         break;
     case SourceOperator::GEQ:
-        value_ = builder_->CreateICmpSGE(lhsValue, rhsValue, "geq");
+        value_ = unsigned_order ? builder_->CreateICmpUGE(lhsValue, rhsValue, "geq") : builder_->CreateICmpSGE(lhsValue, rhsValue, "geq");
         break;
 
     default:
@@ -231,8 +537,8 @@ void CodeGenerator::visit(IdentSelectorExpressionNode &node)
 
 void CodeGenerator::LoadIdentSelector(IdentNode &ident, SelectorNode *selector, bool return_pointer)
 {
-    auto name = ident.get_value();
-    auto var = variables_.lookup(name)->value;
+    const auto &name = ident.get_value();
+    auto var = variables_.lookup(ident.get_symbol())->value;
     auto type = ident.get_actual_type();
 
     if (!selector || selector->get_selector()->empty())
@@ -241,10 +547,18 @@ void CodeGenerator::LoadIdentSelector(IdentNode &ident, SelectorNode *selector,
         return;
     }
 
+    // the selectors of a VAR parameter apply to the variable it refers to
+    note_access(var);
+    auto ident_info = variables_.lookup(ident.get_symbol());
+    if (ident_info->is_pointer)
+    {
+        var = builder_->CreateLoad(ident_info->type->getPointerTo(), var, "load_" + name);
+    }
+
     auto selectors = *(selector->get_selector());
 
     assert(!selectors.empty());
-    llvm::Value *zero = llvm::ConstantInt::get(llvm::Type::getInt64Ty(ctx_), 0);
+    llvm::Value *zero = llvm::ConstantInt::get(llvm::Type::getInt64Ty(*ctx_), 0);
 
     for (auto & tuple_ref : selectors)
     {
@@ -253,19 +567,14 @@ void CodeGenerator::LoadIdentSelector(IdentNode &ident, SelectorNode *selector,
         if (!is_array) // Record field access
         {
             assert(type->tag == TypeTag::RECORD);
-            auto record_fields = std::get<RecordTypeInfo>(type->extended_info.value()).fields;
+            auto &record = std::get<RecordTypeInfo>(type->extended_info.value());
 
             assert(ident_ptr);
-            std::string field_name = ident_ptr->get_value();
+            auto field = record.field(ident_ptr->get_symbol());
+            assert(field && "Field not found in record");
 
-            // Find the field index
-            size_t field_index = std::distance(record_fields.begin(), record_fields.find(field_name));
-            assert(field_index < 0 && "Field not found in record");
-            auto idx = static_cast<uint64_t>(field_index);
-
-            llvm::Value *field_index_val = llvm::ConstantInt::get(llvm::Type::getInt64Ty(ctx_), idx);
-            type = record_fields[field_name];
-            var = builder_->CreateGEP(lookup_or_create_llvm_type(type), var, {zero, field_index_val}, "rec_field_" + field_name);
+            var = builder_->CreateStructGEP(lookup_or_create_llvm_type(type), var, field->index, "rec_field_" + field->name.str());
+            type = field->type;
 
         }
         else // Array access
@@ -277,6 +586,20 @@ void CodeGenerator::LoadIdentSelector(IdentNode &ident, SelectorNode *selector,
             llvm::Value *index_val = value_;
             llvm::Type  *arr_type = lookup_or_create_llvm_type(type);
 
+            if (options_.bounds_check)
+            {
+                auto size = std::get<ArrayTypeInfo>(type->extended_info.value()).size;
+                auto range = ranges_.range_of(*expr_ptr);
+                if (range && range->lo >= 0 && range->hi < size)
+                {
+                    bounds_checks_eliminated_++;
+                }
+                else
+                {
+                    emit_bounds_check(index_val, size);
+                }
+            }
+
             var = builder_->CreateGEP(arr_type, var, {zero, index_val}, "arr_ptr_" + name);
             type = std::get<ArrayTypeInfo>(type->extended_info.value()).element_type;
 
@@ -301,30 +624,29 @@ void CodeGenerator::visit(IdentNode &ident)
 
 void CodeGenerator::LoadIdent(IdentNode &ident, bool return_pointer)
 {
-    std::string name = ident.get_value();
-
-    auto ident_info = variables_.lookup(ident.get_value());
+    const auto &name = ident.get_value();
+    auto ident_info = variables_.lookup(ident.get_symbol());
 
     llvm::Value *var = ident_info->value;
     auto type = ident.get_actual_type();
     auto is_pointer = ident_info->is_pointer;
+    note_access(var);
 
-    if (!var->getType()->isPointerTy() || return_pointer)
+    if (!var->getType()->isPointerTy() || (return_pointer && !is_pointer))
     {
         value_ = var;
     }
     else
     {
-        auto llvm_type = lookup_or_create_llvm_type(type);
-
+        // a VAR parameter holds the address of the variable it refers to
         if (is_pointer)
         {
-            auto val = builder_->CreateLoad(llvm_type->getPointerTo(), var, "load_" + name);
-            auto deref = builder_->CreateLoad(llvm_type, val, "deref_" + name);
-            value_ = deref;
+            auto val = builder_->CreateLoad(ident_info->type->getPointerTo(), var, "load_" + name);
+            value_ = return_pointer ? val : builder_->CreateLoad(ident_info->type, val, "deref_" + name);
         }
         else
         {
+            auto llvm_type = lookup_or_create_llvm_type(type);
             llvm::Value *val = builder_->CreateLoad(llvm_type, var, "load_" + name);
             value_ = val;
         }
@@ -333,19 +655,19 @@ void CodeGenerator::LoadIdent(IdentNode &ident, bool return_pointer)
 
 void CodeGenerator::visit(IntNode &val)
 {
-    value_ = llvm::ConstantInt::get(llvm::Type::getInt64Ty(ctx_),val.get_value());
+    value_ = llvm::ConstantInt::get(llvm::Type::getInt64Ty(*ctx_),val.get_value());
 }
 
 void CodeGenerator::visit(BoolNode &val) {
-    value_ = llvm::ConstantInt::get(llvm::Type::getInt1Ty(ctx_),val.get_value());
+    value_ = llvm::ConstantInt::get(llvm::Type::getInt1Ty(*ctx_),val.get_value());
 }
 
 void CodeGenerator::visit(FloatNode &val) {
-    value_ = llvm::ConstantFP::get(llvm::Type::getFloatTy(ctx_),val.get_value());
+    value_ = llvm::ConstantFP::get(llvm::Type::getFloatTy(*ctx_),val.get_value());
 }
 
 void CodeGenerator::visit(CharNode &val) {
-    value_ = llvm::ConstantInt::get(llvm::Type::getInt8Ty(ctx_),val.get_value());
+    value_ = llvm::ConstantInt::get(llvm::Type::getInt8Ty(*ctx_),val.get_value());
 }
 
 void CodeGenerator::visit(StringNode &val) {
@@ -356,8 +678,8 @@ void CodeGenerator::visit(StringNode &val) {
         return;
     }
 
-    auto arr_type = ArrayType::get(llvm::Type::getInt8Ty(ctx_),value.size() + 1);                           // + 1 because of 0-terminator
-    auto arr_init = ConstantDataArray::getRaw(value,value.size() + 1, llvm::Type::getInt8Ty(ctx_));
+    auto arr_type = ArrayType::get(llvm::Type::getInt8Ty(*ctx_),value.size() + 1);                           // + 1 because of 0-terminator
+    auto arr_init = ConstantDataArray::getRaw(value,value.size() + 1, llvm::Type::getInt8Ty(*ctx_));
     string_literals_[value] = new GlobalVariable(*module_,arr_type,true,GlobalValue::InternalLinkage,arr_init, value + "_LITERAL");
     value_ = string_literals_[value];
 
@@ -379,8 +701,22 @@ void CodeGenerator::create_declarations(DeclarationsNode &node, bool is_global)
     auto types = node.get_typenames();
     for (auto it = types.begin(); it != types.end(); ++it)
     {
-        auto name = it->first->get_value();
-        variables_.insert_type(name, create_llvm_type(it->second->get_actual_type()));
+        auto name = it->first->get_symbol();
+        variables_.insert_type(name, lookup_or_create_llvm_type(it->second->get_actual_type()));
+
+        // declared structures are described under their name, later uses of the type refer to the typedef
+        if (di_builder_)
+        {
+            auto type = it->first->get_formal_type();
+            auto di_type = debug_type(type);
+            if (type->tag != ALIAS)
+            {
+                auto line = static_cast<unsigned>(std::max(SourceManager::resolve(it->first->pos()).lineNo, 0));
+                di_type = di_builder_->createTypedef(di_type, name.str(), di_file_, line, di_scopes_.back());
+                debug_types_[type.get()] = di_type;
+            }
+            debug_type_names_[name] = di_type;
+        }
     }
 
     auto constants = node.get_constants();
@@ -388,25 +724,26 @@ void CodeGenerator::create_declarations(DeclarationsNode &node, bool is_global)
     {
 
         auto ident = it->first;
-        std::string name = ident->get_value();
+        auto name = ident->get_symbol();
 
         auto type = it->first->get_actual_type();
         auto llvm_type = lookup_or_create_llvm_type(type);
 
-        it->second->accept(*this);
-        llvm::Value *value = value_;
+        llvm::Value *value = constant_value(*it->second, llvm_type);
         llvm::Value *var;
         if (is_global)
         {
-            var = new GlobalVariable(*module_, llvm_type, false, GlobalValue::InternalLinkage, dyn_cast<Constant>(value), name);
+            var = new GlobalVariable(*module_, llvm_type, true, GlobalValue::InternalLinkage, dyn_cast<Constant>(value), name.str());
         }
         else
         {
-            var = builder_->CreateAlloca(llvm_type, nullptr, name);
+            var = builder_->CreateAlloca(llvm_type, nullptr, name.str());
             builder_->CreateStore(value, var);
         }
 
         variables_.insert(name,var,llvm_type,false);
+        ranges_.declare_constant(name, *it->second);
+        describe_variable(*ident, var, is_global);
     }
 
     auto variables = node.get_variables();
@@ -418,19 +755,21 @@ void CodeGenerator::create_declarations(DeclarationsNode &node, bool is_global)
             auto type = ident->get_actual_type();
             auto llvm_type = lookup_or_create_llvm_type(type);
 
-            std::string name = ident->get_value();
+            auto name = ident->get_symbol();
 
             llvm::Value *var;
             if (is_global)
             {
-                var = new GlobalVariable(*module_, llvm_type, false, GlobalValue::InternalLinkage, Constant::getNullValue(llvm_type), name);
+                var = new GlobalVariable(*module_, llvm_type, false, GlobalValue::InternalLinkage, Constant::getNullValue(llvm_type), name.str());
             }
             else
             {
-                var = builder_->CreateAlloca(llvm_type, nullptr, name);
+                var = builder_->CreateAlloca(llvm_type, nullptr, name.str());
             }
 
             variables_.insert(name,var, llvm_type, false);
+            ranges_.declare_variable(name, !is_global);
+            describe_variable(*ident, var, is_global);
         }
     }
 
@@ -441,6 +780,17 @@ void CodeGenerator::create_declarations(DeclarationsNode &node, bool is_global)
     }
 }
 
+// The checker stores the value of each named constant on its declaring expression, which therefore is not generated again
+llvm::Value *CodeGenerator::constant_value(ExpressionNode &expr, llvm::Type *type)
+{
+    if (auto value = expr.get_value())
+    {
+        return llvm::ConstantInt::get(type, static_cast<uint64_t>(*value), true);
+    }
+    expr.accept(*this);
+    return value_;
+}
+
 void CodeGenerator::visit(TypeNode &node){(void)node;}
 void CodeGenerator::visit(ArrayTypeNode &node) {(void)node;}
 void CodeGenerator::visit(RecordTypeNode &node){(void)node;}
@@ -451,15 +801,15 @@ llvm::Type *CodeGenerator::create_llvm_type(std::shared_ptr<TypeInfo> type) {
 
     switch(type->tag){
         case INTEGER:
-            return variables_.lookup_type("INTEGER");
+            return variables_.lookup_type(Symbol::integer_type());
         case FLOAT:
-            return variables_.lookup_type("FLOAT");
+            return variables_.lookup_type(Symbol::real_type());
         case BOOLEAN:
-            return variables_.lookup_type("BOOLEAN");
+            return variables_.lookup_type(Symbol::boolean_type());
         case CHAR:
-            return variables_.lookup_type("CHAR");
+            return variables_.lookup_type(Symbol::char_type());
         case STRING:
-            return variables_.lookup_type("STRING");
+            return variables_.lookup_type(Symbol::string_type());
         case ALIAS:
             return variables_.lookup_type(std::get<AliasTypeInfo>(type->extended_info.value()).aliased_type);
         case NIL:
@@ -469,27 +819,27 @@ llvm::Type *CodeGenerator::create_llvm_type(std::shared_ptr<TypeInfo> type) {
 
     if(type->tag == ARRAY){
         auto elem_typeinfo = std::get<ArrayTypeInfo>(type->extended_info.value()).element_type;
-        auto elem_type = create_llvm_type(elem_typeinfo);
+        auto elem_type = lookup_or_create_llvm_type(elem_typeinfo);
 
         auto dim = std::get<ArrayTypeInfo>(type->extended_info.value()).size;
         return llvm::ArrayType::get(elem_type,dim);
     }
 
     if(type->tag == RECORD){
-        auto field_map = std::get<RecordTypeInfo>(type->extended_info.value()).fields;
+        auto &record = std::get<RecordTypeInfo>(type->extended_info.value());
 
         std::vector<llvm::Type*> llvm_fields;
-        for(auto elem: field_map){
-            auto field_type_llvm = create_llvm_type(elem.second);  // Here, there is some room for improvement as this function will possibly be called multiple times with the same parameters
-            llvm_fields.push_back(field_type_llvm);
+        for(auto &field : record.fields()){
+            llvm_fields.push_back(lookup_or_create_llvm_type(field.type));
         }
 
-        return llvm::StructType::create(ctx_,llvm_fields);
+        // Literal struct types are uniqued by LLVM, structurally equal records share one type
+        return llvm::StructType::get(*ctx_,llvm_fields);
     }
 
     if(type->tag == POINTER){
         auto pointee_type = std::get<PointerTypeInfo>(type->extended_info.value()).pointee_type;
-        auto pointee_llvm = create_llvm_type(pointee_type);
+        auto pointee_llvm = lookup_or_create_llvm_type(pointee_type);
         return pointee_llvm->getPointerTo();
     }
 
@@ -497,10 +847,15 @@ llvm::Type *CodeGenerator::create_llvm_type(std::shared_ptr<TypeInfo> type) {
 
 }
 
-llvm::Type *CodeGenerator::lookup_or_create_llvm_type(std::shared_ptr<TypeInfo> type) {
+// Structured types are lowered once per TypeInfo, basic types and aliases are resolved through the type table
+llvm::Type *CodeGenerator::lookup_or_create_llvm_type(const std::shared_ptr<TypeInfo> &type) {
 
-    if(!type->name.empty() && variables_.lookup_type(type->name)){
-        return variables_.lookup_type(type->name);
+    bool structured = type->tag == ARRAY || type->tag == RECORD || type->tag == POINTER;
+    if(structured){
+        auto cached = lowered_types_.find(type.get());
+        if(cached != lowered_types_.end()){
+            return cached->second;
+        }
     }
 
     auto llvm_type = create_llvm_type(type);
@@ -509,20 +864,19 @@ llvm::Type *CodeGenerator::lookup_or_create_llvm_type(std::shared_ptr<TypeInfo>
         panic("LLVM type could not be created from TypeInfo object.");
     }
 
+    if(structured){
+        lowered_types_.emplace(type.get(), llvm_type);
+    }
+
     return llvm_type;
 }
 
-void CodeGenerator::visit(ProcedureDeclarationNode &node)
+// VAR parameters are passed as pointers
+FunctionType *CodeGenerator::procedure_type(ProcedureDeclarationNode &node)
 {
-    auto prev_block = builder_->GetInsertBlock();
-
-    auto name = node.get_names().first->get_value();
     auto arguments = node.get_parameters();
     auto return_type = node.get_return_type_node();
 
-    variables_.beginScope();
-
-    // Create Signature
     std::vector<Type *> llvm_params;
     Type* llvm_return_type = builder_->getVoidTy();
 
@@ -534,7 +888,7 @@ void CodeGenerator::visit(ProcedureDeclarationNode &node)
             bool is_var = std::get<0>(**itr);
             auto idents = std::get<1>(**itr).get();
             auto typenode = std::get<2>(**itr).get();
-            auto llvm_type = create_llvm_type(typenode->get_actual_type());
+            auto llvm_type = lookup_or_create_llvm_type(typenode->get_actual_type());
 
             if (is_var)
             {
@@ -552,17 +906,230 @@ void CodeGenerator::visit(ProcedureDeclarationNode &node)
         llvm_return_type = lookup_or_create_llvm_type(return_type->get_actual_type());
     }
 
-    auto signature = FunctionType::get(llvm_return_type, llvm_params, false);
+    return FunctionType::get(llvm_return_type, llvm_params, false);
+}
+
+// Types of all loaded interfaces are registered under their qualified names, constants and procedures only for the
+// modules imported directly (constants become internal globals, procedures external declarations)
+void CodeGenerator::declare_imports(ModuleNode &node)
+{
+    std::unordered_set<Symbol> imported;
+    for (auto import : node.get_imports())
+    {
+        imported.insert(import->get_symbol());
+    }
+
+    for (auto &[module, declarations] : node.get_interfaces())
+    {
+        for (auto &[ident, type] : declarations->get_typenames())
+        {
+            variables_.insert_type(ident->get_symbol(), lookup_or_create_llvm_type(type->get_actual_type()));
+            if (di_builder_)
+            {
+                debug_type_names_[ident->get_symbol()] = debug_type(ident->get_formal_type());
+            }
+        }
+
+        if (!imported.contains(module))
+        {
+            continue;
+        }
+
+        for (auto &[ident, expr] : declarations->get_constants())
+        {
+            auto name = ident->get_symbol();
+            auto llvm_type = lookup_or_create_llvm_type(ident->get_actual_type());
+            auto var = new GlobalVariable(*module_, llvm_type, true, GlobalValue::InternalLinkage, dyn_cast<Constant>(constant_value(*expr, llvm_type)), name.str());
+            variables_.insert(name, var, llvm_type, false);
+            ranges_.declare_constant(name, *expr);
+        }
+
+        for (auto procedure : declarations->get_procedures())
+        {
+            auto name = procedure->get_names().first->get_symbol();
+            auto function = Function::Create(procedure_type(*procedure), GlobalValue::ExternalLinkage, name.str(), module_);
+            declare_attributes(function, *procedure);
+            procedures_[name] = function;
+        }
+    }
+}
+
+// Name of the function running the body of a library module
+string CodeGenerator::body_function(const string &module)
+{
+    // BEGIN is a keyword, hence no procedure of the module can have this name
+    return module + ".BEGIN";
+}
+
+// Oberon has no exceptions, and a VAR parameter always refers to a variable of its type
+void CodeGenerator::declare_attributes(Function *function, ProcedureDeclarationNode &node)
+{
+    function->addFnAttr(Attribute::NoUnwind);
+
+    auto arguments = node.get_parameters();
+    if (!arguments)
+    {
+        return;
+    }
+
+    unsigned int index = 0;
+    for (auto itr = arguments->begin(); itr != arguments->end(); itr++)
+    {
+        bool is_var = std::get<0>(**itr);
+        auto idents = std::get<1>(**itr).get();
+        auto llvm_type = lookup_or_create_llvm_type(std::get<2>(**itr)->get_actual_type());
+
+        for (auto param = idents->begin(); param != idents->end(); param++, index++)
+        {
+            if (is_var)
+            {
+                function->addParamAttr(index, Attribute::NonNull);
+                function->addDereferenceableParamAttr(index, module_->getDataLayout().getTypeAllocSize(llvm_type).getKnownMinValue());
+            }
+        }
+    }
+}
+
+// A function without loops that only calls functions which return (hence neither recursion nor bounds check traps)
+// returns as well
+void CodeGenerator::infer_will_return(Function &function)
+{
+    SmallVector<std::pair<const BasicBlock *, const BasicBlock *>> back_edges;
+    FindFunctionBackedges(function, back_edges);
+    if (!back_edges.empty())
+    {
+        return;
+    }
+
+    for (auto &block : function)
+    {
+        for (auto &instruction : block)
+        {
+            auto call = dyn_cast<CallBase>(&instruction);
+            if (call && (!call->getCalledFunction() || !call->getCalledFunction()->willReturn()))
+            {
+                return;
+            }
+        }
+    }
+    function.addFnAttr(Attribute::WillReturn);
+}
+
+// Records that the function being generated accesses a global variable, constants do not count as they are never written
+void CodeGenerator::note_access(llvm::Value *var)
+{
+    auto global = dyn_cast<GlobalVariable>(var);
+    if (global && !global->isConstant())
+    {
+        procedure_facts_[builder_->GetInsertBlock()->getParent()].touches_globals = true;
+    }
+}
+
+// Whether two VAR arguments of a call may denote overlapping variables, given the variables they select from:
+// distinct locals and globals do not overlap, but a VAR parameter of the caller may refer to any variable except
+// the caller's locals
+bool CodeGenerator::may_share(Symbol variable, Symbol other)
+{
+    if (variable == other)
+    {
+        return true;
+    }
+
+    auto info = variables_.lookup(variable);
+    auto other_info = variables_.lookup(other);
+    auto is_local = [](VariableInfo *v) { return !v->is_pointer && !isa<GlobalVariable>(v->value); };
+
+    return (info->is_pointer && !is_local(other_info)) || (other_info->is_pointer && !is_local(info));
+}
+
+// The VAR parameters of a procedure only the module calls cannot alias anything the procedure accesses as long as
+// no call passes it overlapping variables and the procedure accesses no global variables
+void CodeGenerator::infer_noalias()
+{
+    for (auto &[function, facts] : procedure_facts_)
+    {
+        if (!function->hasLocalLinkage() || !facts.complete || facts.touches_globals)
+        {
+            continue;
+        }
+
+        for (auto index : facts.var_parameters)
+        {
+            if (!facts.may_alias.contains(index))
+            {
+                function->addParamAttr(index, Attribute::NoAlias);
+            }
+        }
+    }
+}
+
+void CodeGenerator::visit(ProcedureDeclarationNode &node)
+{
+    auto prev_block = builder_->GetInsertBlock();
+    auto prev_location = builder_->getCurrentDebugLocation();
+    auto outer_debug_types = debug_type_names_;
+
+    auto name = node.get_names().first->get_symbol();
+    auto arguments = node.get_parameters();
+    auto return_type = node.get_return_type_node();
+
+    variables_.beginScope();
+    auto outer_ranges = ranges_.enter_procedure();
+
+    // Create Signature
+    auto signature = procedure_type(node);
+    auto llvm_return_type = signature->getReturnType();
 
     // Define Function and add it to FunctionList
-    auto procedure = module_->getOrInsertFunction(name, signature);
+    auto procedure = module_->getOrInsertFunction(module_name_ + "." + name.str(), signature);
     auto function = cast<Function>(procedure.getCallee());
     procedures_[name] = function;
+    declare_attributes(function, node);
+
+    // only the module itself calls the procedures it does not export (i.e. all procedures of a program), so they can
+    // use the fast calling convention
+    bool exported = node.get_names().first->is_exported();
+    if (!exported)
+    {
+        function->setLinkage(GlobalValue::InternalLinkage);
+        function->setCallingConv(CallingConv::Fast);
+    }
+    auto &facts = procedure_facts_[function];
 
     // Define BasicBlock
     auto block = BasicBlock::Create(builder_->getContext(), "entry", function);
     builder_->SetInsertPoint(block);
 
+    // Describe the procedure, VAR parameters are references
+    if (di_builder_)
+    {
+        std::vector<Metadata *> di_signature;
+        di_signature.push_back(return_type ? debug_type(return_type->get_formal_type()) : nullptr);
+        if (arguments)
+        {
+            for (auto itr = arguments->begin(); itr != arguments->end(); itr++)
+            {
+                bool is_var = std::get<0>(**itr);
+                auto idents = std::get<1>(**itr).get();
+                auto di_type = debug_type(std::get<2>(**itr)->get_formal_type());
+                if (is_var)
+                {
+                    di_type = di_builder_->createReferenceType(dwarf::DW_TAG_reference_type, di_type);
+                }
+                di_signature.insert(di_signature.end(), idents->size(), di_type);
+            }
+        }
+
+        auto line = static_cast<unsigned>(std::max(SourceManager::resolve(node.pos()).lineNo, 0));
+        auto subprogram = di_builder_->createFunction(di_scopes_.back(), name.str(), function->getName(), di_file_, line,
+                                                      di_builder_->createSubroutineType(di_builder_->getOrCreateTypeArray(di_signature)), line,
+                                                      DINode::FlagPrototyped,
+                                                      exported ? DISubprogram::SPFlagDefinition : DISubprogram::SPFlagDefinition | DISubprogram::SPFlagLocalToUnit);
+        function->setSubprogram(subprogram);
+        di_scopes_.push_back(subprogram);
+        set_debug_location(node.pos());
+    }
+
     // Set the argument names and update the variables_ table entries
     if (arguments)
     {
@@ -587,8 +1154,25 @@ void CodeGenerator::visit(ProcedureDeclarationNode &node)
                 auto param_value = builder_->CreateAlloca(param_type, nullptr,param->get()->get_value());
                 builder_->CreateStore(arg_itr,param_value);
 
-                variables_.insert(param->get()->get_value(),param_value,llvm_type,is_var);
+                variables_.insert(param->get()->get_symbol(),param_value,llvm_type,is_var);
+                ranges_.declare_variable(param->get()->get_symbol(), !is_var, is_var);
                 arg_itr->setName(param->get()->get_value());
+                if (is_var)
+                {
+                    facts.var_parameters.push_back(arg_itr->getArgNo());
+                }
+
+                if (di_builder_)
+                {
+                    auto di_type = debug_type(param->get()->get_formal_type() ? param->get()->get_formal_type() : arg_type);
+                    if (is_var)
+                    {
+                        di_type = di_builder_->createReferenceType(dwarf::DW_TAG_reference_type, di_type);
+                    }
+                    auto line = static_cast<unsigned>(std::max(SourceManager::resolve(param->get()->pos()).lineNo, 0));
+                    auto variable = di_builder_->createParameterVariable(di_scopes_.back(), param->get()->get_value(), arg_itr->getArgNo() + 1, di_file_, line, di_type, true);
+                    di_builder_->insertDeclare(param_value, variable, di_builder_->createExpression(), debug_location(param->get()->pos()), block);
+                }
                 arg_itr++;
             }
         }
@@ -599,16 +1183,28 @@ void CodeGenerator::visit(ProcedureDeclarationNode &node)
     visit(*node.get_statements());
 
     variables_.endScope();
+    ranges_.leave_procedure(std::move(outer_ranges));
 
     // Add Return in case of void type
     if(llvm_return_type == builder_->getVoidTy()){
         builder_->CreateRetVoid();
     }
+    facts.complete = true;
+    infer_will_return(*function);
+
+    if (di_builder_)
+    {
+        di_scopes_.pop_back();
+        di_builder_->finalizeSubprogram(function->getSubprogram());
+        debug_type_names_ = std::move(outer_debug_types);
+    }
     builder_->SetInsertPoint(prev_block);
+    builder_->SetCurrentDebugLocation(prev_location);
 }
 
 void CodeGenerator::visit(StatementNode &node)
 {
+    set_debug_location(node.pos());
     switch (node.getNodeType())
     {
     case NodeType::assignment:
@@ -644,7 +1240,7 @@ void CodeGenerator::visit(AssignmentNode &node)
     // Special case: NIL assigned to a pointer type
     auto value = value_;
     if(expr->getNodeType() == NodeType::nil){
-        auto ident_info = variables_.lookup(ident->get_value());
+        auto ident_info = variables_.lookup(ident->get_symbol());
         auto pointer_type = ident_info->type;
         value = llvm::ConstantPointerNull::get(static_cast<llvm::PointerType*>(pointer_type));
     }
@@ -655,6 +1251,7 @@ void CodeGenerator::visit(AssignmentNode &node)
 
     LoadIdentSelector(*ident, selector, true);
     builder_->CreateStore(value, value_);
+    ranges_.assign(*ident, selector, *expr);
 }
 
 void CodeGenerator::visit(IfStatementNode &node)
@@ -686,6 +1283,7 @@ void CodeGenerator::visit(IfStatementNode &node)
     auto post_branch = BasicBlock::Create(builder_->getContext(), "post_branch", builder_->GetInsertBlock()->getParent());
 
     // Evaluate initial condition
+    set_debug_location(node.get_condition()->pos());
     visit(*node.get_condition());
     auto initial_cond = value_;
 
@@ -707,6 +1305,7 @@ void CodeGenerator::visit(IfStatementNode &node)
         {
 
             builder_->SetInsertPoint(cond_branches[i]);
+            set_debug_location((*else_ifs)[i].first->pos());
             visit(*(*else_ifs)[i].first);
             auto cond = value_;
 
@@ -721,10 +1320,16 @@ void CodeGenerator::visit(IfStatementNode &node)
         }
     }
 
+    // Value ranges at the start of each branch (refined by its condition) and at its end
+    auto ranges_before = ranges_.facts();
+    std::vector<RangeFacts> ranges_after;
+
     // Populate initial then-block
     builder_->SetInsertPoint(then);
+    ranges_.assume(*node.get_condition());
     visit(*node.get_then());
     builder_->CreateBr(post_branch);
+    ranges_after.push_back(ranges_.facts());
 
     // Populate "Then" Blocks
     if (else_ifs)
@@ -732,8 +1337,11 @@ void CodeGenerator::visit(IfStatementNode &node)
         for (long unsigned int i = 0; i < then_branches.size(); i++)
         {
             builder_->SetInsertPoint(then_branches[i]);
+            ranges_.restore(ranges_before);
+            ranges_.assume(*(*else_ifs)[i].first);
             visit(*(*else_ifs)[i].second);
             builder_->CreateBr(post_branch);
+            ranges_after.push_back(ranges_.facts());
         }
     }
 
@@ -741,9 +1349,16 @@ void CodeGenerator::visit(IfStatementNode &node)
     if (node.get_else())
     {
         builder_->SetInsertPoint(else_block);
+        ranges_.restore(ranges_before);
         visit(*node.get_else());
         builder_->CreateBr(post_branch);
+        ranges_after.push_back(ranges_.facts());
+    }
+    else
+    {
+        ranges_after.push_back(ranges_before);
     }
+    ranges_.join(ranges_after);
 
     // Continue post branch
     builder_->SetInsertPoint(post_branch);
@@ -755,18 +1370,20 @@ void CodeGenerator::visit(ProcedureCallNode &node)
     auto procedure_name = node.get_name();
     if (procedures_.find(procedure_name) == procedures_.end())
     {
-        panic("Code generator could not find procedure '" + procedure_name + "' in procedure_list.");
+        panic("Code generator could not find procedure '" + procedure_name.str() + "' in procedure_list.");
     }
 
     // Get Arguments
     if (!node.get_declaration())
     {
-        panic("Declaration node pointer not set for call to procedure '" + procedure_name + "'.");
+        panic("Declaration node pointer not set for call to procedure '" + procedure_name.str() + "'.");
     }
 
     auto formal_parameters = node.get_declaration()->get_parameters();
     auto actual_parameters = node.get_parameters();
     std::vector<Value *> arguments;
+    // index and variable (without selectors) of each VAR argument
+    std::vector<std::pair<unsigned, Symbol>> var_arguments;
 
     if (formal_parameters && actual_parameters)
     {
@@ -782,7 +1399,7 @@ void CodeGenerator::visit(ProcedureCallNode &node)
 
                 if (act_itr == actual_parameters->end())
                 {
-                    panic("Number of actual parameters does not equal number of formal parameters for call to procedure '" + procedure_name + "'.");
+                    panic("Number of actual parameters does not equal number of formal parameters for call to procedure '" + procedure_name.str() + "'.");
                 }
 
                 // Generate argument
@@ -791,11 +1408,12 @@ void CodeGenerator::visit(ProcedureCallNode &node)
                 {
                     if ((**act_itr).getNodeType() != NodeType::ident_selector_expression)
                     {
-                        panic("Constant expression for VAR argument in call to '" + procedure_name + "'.");
+                        panic("Constant expression for VAR argument in call to '" + procedure_name.str() + "'.");
                     }
 
                     auto id_expr = dynamic_cast<IdentSelectorExpressionNode *>((*act_itr).get());
                     LoadIdentSelector(*(id_expr->get_identifier()), id_expr->get_selector(), true);
+                    var_arguments.emplace_back(arguments.size(), id_expr->get_identifier()->get_symbol());
                 }
                 else
                 {
@@ -809,7 +1427,29 @@ void CodeGenerator::visit(ProcedureCallNode &node)
     }
 
     // Create Call
-    value_ = builder_->CreateCall(procedures_[procedure_name], arguments);
+    auto callee = procedures_.find(procedure_name)->second;
+    auto call = builder_->CreateCall(callee, arguments);
+    call->setCallingConv(callee->getCallingConv());
+    value_ = call;
+    ranges_.call(node);
+
+    // Whatever the callee accesses, the caller accesses too (unless it is not known yet, e.g. for imported procedures)
+    auto caller = builder_->GetInsertBlock()->getParent();
+    auto &callee_facts = procedure_facts_[callee];
+    if (callee != caller && (!callee_facts.complete || callee_facts.touches_globals))
+    {
+        procedure_facts_[caller].touches_globals = true;
+    }
+    for (auto &[index, variable] : var_arguments)
+    {
+        for (auto &[other_index, other_variable] : var_arguments)
+        {
+            if (index != other_index && may_share(variable, other_variable))
+            {
+                callee_facts.may_alias.insert(index);
+            }
+        }
+    }
 }
 
 void CodeGenerator::visit(RepeatStatementNode &node)
@@ -823,9 +1463,11 @@ void CodeGenerator::visit(RepeatStatementNode &node)
     builder_->SetInsertPoint(loop);
 
     // Loop statements
+    ranges_.loop_head(node.get_statements(), node.get_expr(), false);
     visit(*node.get_statements());
 
     // Check condition
+    set_debug_location(node.get_expr()->pos());
     visit(*node.get_expr());
     auto cond = value_;
 
@@ -860,14 +1502,18 @@ void CodeGenerator::visit(WhileStatementNode &node)
     // Jump into check
     builder_->CreateBr(check);
 
-    // Create Loop Block
+    // Create Loop Block, the condition holds whenever the body is entered
     builder_->SetInsertPoint(loop);
+    auto ranges_head = ranges_.loop_head(node.get_statements(), node.get_expr(), true);
+    ranges_.assume(*node.get_expr());
     visit(*node.get_statements());
     builder_->CreateBr(check);
 
     // Check Condition
     builder_->SetInsertPoint(check);
+    ranges_.restore(std::move(ranges_head));
 
+    set_debug_location(node.get_expr()->pos());
     visit(*node.get_expr());
     auto cond = value_;
 
@@ -892,35 +1538,191 @@ void CodeGenerator::visit(ModuleNode &node)
 {
 
     variables_.beginScope();
-    variables_.insert_type("INTEGER",llvm::Type::getInt64Ty(ctx_));
-    variables_.insert_type("BOOLEAN",llvm::Type::getInt1Ty(ctx_));
-    variables_.insert_type("REAL",llvm::Type::getFloatTy(ctx_));
-    variables_.insert_type("CHAR",llvm::Type::getInt8Ty(ctx_));
-    variables_.insert_type("STRING",llvm::Type::getInt8Ty(ctx_)->getPointerTo());
-
-    // define main
-    auto main = module_->getOrInsertFunction("main", builder_->getInt64Ty());
+    variables_.insert_type(Symbol::integer_type(),llvm::Type::getInt64Ty(*ctx_));
+    variables_.insert_type(Symbol::boolean_type(),llvm::Type::getInt1Ty(*ctx_));
+    variables_.insert_type(Symbol::real_type(),llvm::Type::getFloatTy(*ctx_));
+    variables_.insert_type(Symbol::char_type(),llvm::Type::getInt8Ty(*ctx_));
+    variables_.insert_type(Symbol::string_type(),llvm::Type::getInt8Ty(*ctx_)->getPointerTo());
+
+    module_name_ = node.get_name().first->get_value();
+
+    // the body of a program is its main function, the body of a library is run (once) by the bodies of its importers
+    bool library = node.has_exports();
+    auto body_type = library ? FunctionType::get(builder_->getVoidTy(), false) : FunctionType::get(builder_->getInt64Ty(), false);
+    auto body_name = library ? body_function(module_name_) : "main";
+    auto main = module_->getOrInsertFunction(body_name, body_type);
     auto main_fct = cast<Function>(main.getCallee());
+    main_fct->addFnAttr(Attribute::NoUnwind);
     auto entry = BasicBlock::Create(builder_->getContext(), "entry", main_fct);
     builder_->SetInsertPoint(entry);
 
+    if (library)
+    {
+        auto initialized = new GlobalVariable(*module_, builder_->getInt1Ty(), false, GlobalValue::InternalLinkage, builder_->getFalse(), module_name_ + ".initialized");
+        auto done = BasicBlock::Create(builder_->getContext(), "done", main_fct);
+        auto init = BasicBlock::Create(builder_->getContext(), "init", main_fct);
+        builder_->CreateCondBr(builder_->CreateLoad(builder_->getInt1Ty(), initialized, "initialized"), done, init);
+        builder_->SetInsertPoint(done);
+        builder_->CreateRetVoid();
+        builder_->SetInsertPoint(init);
+        builder_->CreateStore(builder_->getTrue(), initialized);
+    }
+
+    // the module body is described as a subprogram of its own
+    if (di_builder_)
+    {
+        auto di_char = di_builder_->createBasicType("CHAR", 8, dwarf::DW_ATE_unsigned_char);
+        debug_type_names_[Symbol::integer_type()] = di_builder_->createBasicType("INTEGER", 64, dwarf::DW_ATE_signed);
+        debug_type_names_[Symbol::boolean_type()] = di_builder_->createBasicType("BOOLEAN", 8, dwarf::DW_ATE_boolean);
+        debug_type_names_[Symbol::real_type()] = di_builder_->createBasicType("REAL", 32, dwarf::DW_ATE_float);
+        debug_type_names_[Symbol::char_type()] = di_char;
+        debug_type_names_[Symbol::string_type()] = di_builder_->createPointerType(di_char, module_->getDataLayout().getPointerSizeInBits());
+
+        auto line = static_cast<unsigned>(std::max(SourceManager::resolve(node.pos()).lineNo, 0));
+        auto signature = di_builder_->createSubroutineType(di_builder_->getOrCreateTypeArray({library ? nullptr : debug_type_names_[Symbol::integer_type()]}));
+        auto subprogram = di_builder_->createFunction(di_unit_, body_name, body_name, di_file_, line, signature, line,
+                                                      DINode::FlagPrototyped, DISubprogram::SPFlagDefinition);
+        main_fct->setSubprogram(subprogram);
+    }
+
+    // exports of the imported modules
+    declare_imports(node);
+
     // global declarations
     create_declarations(*node.get_declarations(), true);
 
+    if (di_builder_)
+    {
+        di_scopes_.push_back(main_fct->getSubprogram());
+        set_debug_location(node.pos());
+    }
+
+    // imported modules are initialized before the body runs
+    for (auto import : node.get_imports())
+    {
+        auto import_body = module_->getOrInsertFunction(body_function(import->get_value()), FunctionType::get(builder_->getVoidTy(), false));
+        cast<Function>(import_body.getCallee())->addFnAttr(Attribute::NoUnwind);
+        builder_->CreateCall(import_body);
+    }
+
     // statements
-    visit(*node.get_statements());
+    if (node.get_statements())
+    {
+        visit(*node.get_statements());
+    }
 
     variables_.endScope();
 
     // return value
-    builder_->CreateRet(builder_->getInt64(0));
+    if (library)
+    {
+        builder_->CreateRetVoid();
+    }
+    else
+    {
+        builder_->CreateRet(builder_->getInt64(0));
+    }
+    if (di_builder_)
+    {
+        di_scopes_.pop_back();
+        di_builder_->finalizeSubprogram(main_fct->getSubprogram());
+    }
+    infer_will_return(*main_fct);
+    infer_noalias();
     verifyFunction(*main_fct, &errs());
 }
 
-void CodeGenerator::emit()
+// Runs the default new-pass-manager pipeline matching the requested optimization level over the module
+void CodeGenerator::optimize()
+{
+    // -O0 keeps the module exactly as generated, unless it has to be instrumented
+    if (options_.opt_level == OptLevel::O0 && !options_.profile_generate)
+    {
+        return;
+    }
+
+    llvm::OptimizationLevel level;
+    switch (options_.opt_level)
+    {
+    case OptLevel::O0:
+        level = llvm::OptimizationLevel::O0;
+        break;
+    case OptLevel::O1:
+        level = llvm::OptimizationLevel::O1;
+        break;
+    case OptLevel::O3:
+        level = llvm::OptimizationLevel::O3;
+        break;
+    default:
+        level = llvm::OptimizationLevel::O2;
+        break;
+    }
+
+    // Note: the analysis managers have to be declared in this order so that they are destroyed correctly
+    LoopAnalysisManager lam;
+    FunctionAnalysisManager fam;
+    CGSCCAnalysisManager cgam;
+    ModuleAnalysisManager mam;
+
+    PassBuilder pass_builder(target_, PipelineTuningOptions(), pgo_options());
+    pass_builder.registerModuleAnalyses(mam);
+    pass_builder.registerCGSCCAnalyses(cgam);
+    pass_builder.registerFunctionAnalyses(fam);
+    pass_builder.registerLoopAnalyses(lam);
+    pass_builder.crossRegisterProxies(lam, fam, cgam, mam);
+
+    // the -O0 pipeline only runs the mandatory passes and the PGO instrumentation, whole programs are optimized in two
+    // steps: each module is simplified (and instrumented) on its own, the linked module is then optimized as a whole
+    ModulePassManager pipeline;
+    if (linked_)
+    {
+        pipeline = pass_builder.buildLTODefaultPipeline(level, nullptr);
+    }
+    else if (options_.whole_program)
+    {
+        pipeline = pass_builder.buildLTOPreLinkDefaultPipeline(level);
+    }
+    else
+    {
+        pipeline = (level == llvm::OptimizationLevel::O0) ? pass_builder.buildO0DefaultPipeline(level) : pass_builder.buildPerModuleDefaultPipeline(level);
+    }
+    pipeline.run(*module_, mam);
+}
+
+// Instrumentation and profile use work on the IR level, the pipeline places them before the optimizations that profit from them
+#ifdef _LLVM_LEGACY
+Optional<PGOOptions> CodeGenerator::pgo_options() const
+#else
+std::optional<PGOOptions> CodeGenerator::pgo_options() const
+#endif
+{
+    if (options_.profile_generate)
+    {
+#if defined(_LLVM_17) || defined(_LLVM_18)
+        return PGOOptions("", "", "", "", vfs::getRealFileSystem(), PGOOptions::IRInstr);
+#else
+        return PGOOptions("", "", "", PGOOptions::IRInstr);
+#endif
+    }
+    if (!options_.profile_use.empty())
+    {
+#if defined(_LLVM_17) || defined(_LLVM_18)
+        return PGOOptions(options_.profile_use, "", "", "", vfs::getRealFileSystem(), PGOOptions::IRUse);
+#else
+        return PGOOptions(options_.profile_use, "", "", PGOOptions::IRUse);
+#endif
+    }
+#ifdef _LLVM_LEGACY
+    return None;
+#else
+    return std::nullopt;
+#endif
+}
+
+string CodeGenerator::output_file(const string &filename, OutputFileType type)
 {
     std::string ext;
-    switch (output_type_)
+    switch (type)
     {
     case OutputFileType::AssemblyFile:
         ext = ".s";
@@ -928,6 +1730,9 @@ void CodeGenerator::emit()
     case OutputFileType::LLVMIRFile:
         ext = ".ll";
         break;
+    case OutputFileType::BitcodeFile:
+        ext = ".bc";
+        break;
     default:
 #if (defined(_WIN32) || defined(_WIN64)) && !defined(__MINGW32__)
         ext = ".obj";
@@ -936,7 +1741,12 @@ void CodeGenerator::emit()
 #endif
         break;
     }
-    std::string file = filename_ + ext;
+    return filename + ext;
+}
+
+bool CodeGenerator::emit(Logger &logger)
+{
+    std::string file = output_file(filename_, options_.output_type);
 
     // serialize LLVM module to file
     std::error_code ec;
@@ -944,51 +1754,279 @@ void CodeGenerator::emit()
     raw_fd_ostream output(file, ec, llvm::sys::fs::OF_None);
     if (ec)
     {
-        std::cerr << ec.message() << std::endl;
-        exit(ec.value());
+        logger.error(file, "Could not write output file: " + ec.message());
+        return false;
     }
-    if (output_type_ == OutputFileType::LLVMIRFile)
+    return emit(output, logger);
+}
+
+// Branches to a shared trap block at the end of the function if the index is out of bounds, the branch is marked as cold
+void CodeGenerator::emit_bounds_check(llvm::Value *index, int64_t size)
+{
+    auto function = builder_->GetInsertBlock()->getParent();
+
+    auto &trap = trap_blocks_[function];
+    if (!trap)
     {
-        module_->print(output, nullptr);
-        output.flush();
-        return;
+        trap = BasicBlock::Create(*ctx_, "bounds_trap", function);
+        IRBuilder<> trap_builder(trap);
+        trap_builder.SetCurrentDebugLocation(builder_->getCurrentDebugLocation());
+        if (options_.runtime)
+        {
+            auto oberon_trap = module_->getOrInsertFunction("oberon_trap", FunctionType::get(builder_->getVoidTy(), {builder_->getInt64Ty()}, false));
+            auto trap_function = cast<Function>(oberon_trap.getCallee());
+            trap_function->setDoesNotReturn();
+            trap_function->addFnAttr(Attribute::NoUnwind);
+            trap_function->addFnAttr(Attribute::Cold);
+            trap_builder.CreateCall(oberon_trap, {trap_builder.getInt64(TRAP_INDEX_OUT_OF_BOUNDS)});
+        }
+        else
+        {
+            trap_builder.CreateCall(Intrinsic::getDeclaration(module_, Intrinsic::trap));
+        }
+        trap_builder.CreateUnreachable();
+    }
+
+    // An unsigned comparison also catches negative indices
+    auto in_bounds = builder_->CreateICmpULT(index, llvm::ConstantInt::get(index->getType(), static_cast<uint64_t>(size)), "in_bounds");
+    auto next = BasicBlock::Create(*ctx_, "in_bounds", function);
+    builder_->CreateCondBr(in_bounds, next, trap, MDBuilder(*ctx_).createBranchWeights(1u << 20, 1));
+    builder_->SetInsertPoint(next);
+
+    bounds_checks_emitted_++;
+}
+
+unsigned int CodeGenerator::get_emitted_bounds_checks() const
+{
+    return bounds_checks_emitted_;
+}
+
+unsigned int CodeGenerator::get_eliminated_bounds_checks() const
+{
+    return bounds_checks_eliminated_;
+}
+
+bool CodeGenerator::emit(SmallVectorImpl<char> &buffer, Logger &logger)
+{
+    raw_svector_ostream output(buffer);
+    return emit(output, logger);
+}
+
+// The number of partitions only depends on the size of the module, so that the object code is the same for any number of threads
+unsigned int CodeGenerator::partition_count() const
+{
+    const size_t instructions_per_partition = 20000;
+    const size_t max_partitions = 16;
+
+    size_t instructions = 0;
+    for (auto &function : *module_)
+    {
+        instructions += function.getInstructionCount();
     }
-    CodeGenFileType ft;
+    return static_cast<unsigned int>(std::clamp<size_t>(instructions / instructions_per_partition, 1, max_partitions));
+}
 
-    switch (output_type_)
+bool CodeGenerator::emit(std::vector<SmallVector<char, 0>> &objects, Logger &logger)
+{
+    auto partitions = (options_.codegen_jobs == 0 || options_.output_type != OutputFileType::ObjectFile) ? 1 : partition_count();
+    if (partitions == 1)
     {
-    case OutputFileType::AssemblyFile:
-#ifdef _LLVM_18
-        ft = CodeGenFileType::AssemblyFile;
-#else
-        ft = CodeGenFileType::CGFT_AssemblyFile;
-#endif
-        break;
-    default:
-#ifdef _LLVM_18
-        ft = CodeGenFileType::ObjectFile;
-#else
-        ft = CodeGenFileType::CGFT_ObjectFile;
-#endif
-        break;
+        return emit(objects.emplace_back(), logger);
     }
 
+    // SplitModule promotes local symbols to hidden globals so that the partitions link back together, they are prefixed
+    // with the module name so that they cannot clash with symbols of other modules linked into the same executable
+    auto prefix = sys::path::stem(filename_).str() + ".";
+    for (auto &global : module_->global_values())
+    {
+        if (global.hasLocalLinkage())
+        {
+            global.setName(prefix + global.getName());
+        }
+    }
+
+    // Partitions are passed to the threads as bitcode, each thread reads its partitions into a context of its own
+    std::vector<SmallVector<char, 0>> bitcode;
+    SplitModule(*module_, partitions, [&bitcode](std::unique_ptr<Module> partition) {
+        raw_svector_ostream output(bitcode.emplace_back());
+        WriteBitcodeToFile(*partition, output);
+    });
+
+    auto first_object = objects.size();
+    objects.resize(first_object + bitcode.size());
+    std::atomic<size_t> next_partition = 0;
+    // the threads only record their errors, they are reported once all threads are done
+    std::vector<string> errors(bitcode.size());
+
+    auto worker = [&]() {
+        // a TargetMachine must not be shared between threads
+        std::unique_ptr<TargetMachine> target(target_->getTarget().createTargetMachine(
+                target_->getTargetTriple().str(), target_->getTargetCPU(), target_->getTargetFeatureString(), target_->Options,
+                target_->getRelocationModel(), target_->getCodeModel(), target_->getOptLevel()));
+
+        for (auto i = next_partition++; i < bitcode.size(); i = next_partition++)
+        {
+            LLVMContext ctx;
+            auto partition = parseBitcodeFile(MemoryBufferRef(StringRef(bitcode[i].data(), bitcode[i].size()), filename_), ctx);
+            if (!partition)
+            {
+                errors[i] = "Could not read module partition: " + toString(partition.takeError());
+                continue;
+            }
+
+            raw_svector_ostream output(objects[first_object + i]);
+            legacy::PassManager pass;
+            if (target->addPassesToEmitFile(pass, output, nullptr, to_file_type(options_.output_type)))
+            {
+                errors[i] = "Target machine cannot emit object code.";
+                continue;
+            }
+            pass.run(**partition);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned int i = 0; i < std::min(options_.codegen_jobs, partitions); i++)
+    {
+        pool.emplace_back(worker);
+    }
+    for (auto &thread : pool)
+    {
+        thread.join();
+    }
+
+    bool emitted = true;
+    for (auto &error : errors)
+    {
+        if (!error.empty())
+        {
+            logger.error(filename_, error);
+            emitted = false;
+        }
+    }
+    return emitted;
+}
+
+bool CodeGenerator::emit(raw_pwrite_stream &output, Logger &logger)
+{
+    if (options_.output_type == OutputFileType::LLVMIRFile)
+    {
+        module_->print(output, nullptr);
+        output.flush();
+        return true;
+    }
+    if (options_.output_type == OutputFileType::BitcodeFile)
+    {
+        WriteBitcodeToFile(*module_, output);
+        output.flush();
+        return true;
+    }
     legacy::PassManager pass;
-    if (target_->addPassesToEmitFile(pass, output, nullptr, ft))
+    if (target_->addPassesToEmitFile(pass, output, nullptr, to_file_type(options_.output_type)))
     {
-        std::cerr << "Error: target machine cannot emit a file of this type." << std::endl;
-        return;
+        logger.error(filename_, "Target machine cannot emit a file of this type.");
+        return false;
     }
     pass.run(*module_);
     output.flush();
+    return true;
 }
 
-void CodeGenerator::generate_code(ModuleNode &node) {
-
+void CodeGenerator::generate_ir(ModuleNode &node)
+{
     visit(node);
 
+    // resolves the debug metadata, the builder must not outlive the module's context
+    if (di_builder_)
+    {
+        di_builder_->finalize();
+        di_builder_.reset();
+    }
+
     // verify module
     verifyModule(*module_, &errs());
+}
+
+bool CodeGenerator::generate_code(ModuleNode &node, Logger &logger) {
+
+    generate_ir(node);
+    optimize();
+    return emit(logger);
+}
+
+bool CodeGenerator::link_modules(std::vector<std::pair<string, SmallVector<char, 0>>> &bitcode, Logger &logger)
+{
+    Linker linker(*module_);
+    for (auto &[name, code] : bitcode)
+    {
+        auto module = parseBitcodeFile(MemoryBufferRef(StringRef(code.data(), code.size()), name), *ctx_);
+        if (!module)
+        {
+            logger.error(name, "Could not read bitcode: " + toString(module.takeError()));
+            return false;
+        }
+        // reports conflicting definitions (e.g. two main programs) through the context's diagnostic handler
+        if (linker.linkInModule(std::move(*module)))
+        {
+            return false;
+        }
+    }
+
+    // Only main is called from outside of the program, the profile runtime looks up the instrumentation's variables by name
+    internalizeModule(*module_, [](const GlobalValue &global) {
+        return global.getName() == "main" || global.getName().find("__llvm_profile") == 0;
+    });
+    linked_ = true;
+    return true;
+}
+
+bool CodeGenerator::run(int &exit_code, Logger &logger)
+{
+
+    // the JIT has to generate code for the same target the module was built for
+    orc::JITTargetMachineBuilder target_builder(target_->getTargetTriple());
+    target_builder.setCPU(target_->getTargetCPU().str());
+    target_builder.setFeatures(target_->getTargetFeatureString());
+    target_builder.setCodeGenOptLevel(to_codegen_level(options_.opt_level));
+
+    auto jit = orc::LLJITBuilder().setJITTargetMachineBuilder(std::move(target_builder)).create();
+    if (!jit)
+    {
+        logger.error(filename_, "Could not create JIT: " + toString(jit.takeError()));
+        return false;
+    }
+
+    // make symbols of the host process (e.g. the C library) available to the program
+    auto process_symbols = orc::DynamicLibrarySearchGenerator::GetForCurrentProcess((*jit)->getDataLayout().getGlobalPrefix());
+    if (!process_symbols)
+    {
+        logger.error(filename_, "Could not load process symbols: " + toString(process_symbols.takeError()));
+        return false;
+    }
+    (*jit)->getMainJITDylib().addGenerator(std::move(*process_symbols));
+
+    // the JIT takes ownership of both the module and its context
+    auto thread_safe_module = orc::ThreadSafeModule(std::unique_ptr<Module>(module_), std::move(ctx_));
+    module_ = nullptr;
+    if (auto err = (*jit)->addIRModule(std::move(thread_safe_module)))
+    {
+        logger.error(filename_, "Could not add module to JIT: " + toString(std::move(err)));
+        return false;
+    }
+
+    auto main_symbol = (*jit)->lookup("main");
+    if (!main_symbol)
+    {
+        logger.error(filename_, "Could not find main function: " + toString(main_symbol.takeError()));
+        return false;
+    }
+
+#ifdef _LLVM_LEGACY
+    auto main_function = reinterpret_cast<int64_t (*)()>(main_symbol->getAddress());
+#else
+    auto main_function = main_symbol->toPtr<int64_t (*)()>();
+#endif
 
-    emit();
+    exit_code = static_cast<int>(main_function());
+    return true;
 }
\ No newline at end of file
@@ -7,6 +7,7 @@
 
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 
 #include <llvm/IR/LLVMContext.h>
@@ -14,27 +15,84 @@
 #include <llvm/IR/Type.h>
 #include <llvm/IR/DataLayout.h>
 #include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/DIBuilder.h>
+#include <llvm/IR/Intrinsics.h>
+#include <llvm/IR/MDBuilder.h>
 #include <llvm/IR/Module.h>
 #include <llvm/IR/Verifier.h>
 #include <llvm/IR/LegacyPassManager.h>
+#include <llvm/Analysis/CFG.h>
+#include <llvm/Linker/Linker.h>
+#include <llvm/Passes/PassBuilder.h>
+#include <llvm/Bitcode/BitcodeReader.h>
 #include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/ExecutionEngine/Orc/LLJIT.h>
+#include <llvm/ExecutionEngine/Orc/ExecutionUtils.h>
 #include <llvm/MC/TargetRegistry.h>
 #include <llvm/Target/TargetMachine.h>
 #include <llvm/Target/TargetOptions.h>
 #include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/VirtualFileSystem.h>
 #include <llvm/TargetParser/Host.h>
+#if defined(_LLVM_LEGACY) || defined(_LLVM_16)
+#include <llvm/MC/SubtargetFeature.h>
+#else
+#include <llvm/TargetParser/SubtargetFeature.h>
+#endif
 #include <llvm/Support/TargetSelect.h>
 #include <llvm/Support/raw_ostream.h>
+#include <llvm/Transforms/IPO/Internalize.h>
+#include <llvm/Transforms/Utils/SplitModule.h>
 
+#include "util/Logger.h"
 #include "util/datastructures/tables/TypeInfo.hpp"
 #include "util/datastructures/ast/NodeVisitor.h"
 #include "util/datastructures/tables/LLVMValueTable.h"
+#include "RangeAnalysis.h"
 
 enum class OutputFileType
 {
     AssemblyFile,
     LLVMIRFile,
-    ObjectFile
+    ObjectFile,
+    BitcodeFile
+};
+
+enum class OptLevel
+{
+    O0,
+    O1,
+    O2,
+    O3
+};
+
+struct CodeGenOptions
+{
+    OutputFileType output_type = OutputFileType::LLVMIRFile;
+    OptLevel opt_level = OptLevel::O0;
+    // empty strings select the defaults (host triple, generic CPU, no extra features), "native" selects the host
+    string target_triple;
+    string cpu;
+    string features;
+    // object code is linked into a position independent executable
+    bool position_independent = false;
+    // array indices are checked at runtime unless they are proven to be in bounds
+    bool bounds_check = false;
+    // the Oberon runtime is linked into the program (-o), failed checks are reported by it instead of trapping silently
+    bool runtime = false;
+    // DWARF (or CodeView) debug information is attached to the module
+    bool debug_info = false;
+    // procedures and branches are instrumented to write a raw profile at exit (default.profraw unless LLVM_PROFILE_FILE is set)
+    bool profile_generate = false;
+    // indexed profile (llvm-profdata merge) whose branch weights and entry counts are attached before optimization
+    string profile_use;
+    // 0 lowers the module as a whole, otherwise large modules are split into partitions (independent of this number)
+    // that are lowered to object code on up to this many threads
+    unsigned int codegen_jobs = 0;
+    // modules are only prepared for link-time optimization and emitted as bitcode, link_modules() combines them into one
+    // module that is optimized as a whole, so that procedures can be inlined across module boundaries
+    bool whole_program = false;
 };
 
 using namespace llvm;
@@ -45,23 +103,76 @@ class CodeGenerator : public NodeVisitor
 private:
     TargetMachine *target_;
     Module *module_;
-    LLVMContext ctx_;
-    OutputFileType output_type_;
+    std::unique_ptr<LLVMContext> ctx_;
+    CodeGenOptions options_;
     const string filename_;
     IRBuilder<> *builder_;
+    // set once the module consists of the linked modules of a whole program
+    bool linked_ = false;
 
-    std::unordered_map<string, Function *> procedures_;
+    // procedures are named "<Module>.<Procedure>" in the generated code, which keeps the names of separately compiled
+    // modules apart (identifiers cannot contain a period)
+    string module_name_;
+    std::unordered_map<Symbol, Function *> procedures_;
     std::unordered_map<string, llvm::Value*> string_literals_; // String literals are stored as global variables
     LLVMValueTable variables_;
+    std::unordered_map<const TypeInfo *, llvm::Type *> lowered_types_; // Module-wide cache of lowered array, record and pointer types
+
+    // What is known about the procedures generated so far, decides which VAR parameters are noalias (see infer_noalias)
+    struct ProcedureFacts
+    {
+        bool complete = false;
+        // the procedure, or a procedure it calls, accesses a global variable (which a VAR argument may denote as well)
+        bool touches_globals = false;
+        std::vector<unsigned> var_parameters;
+        // VAR parameters to which a call passes a variable that another VAR argument of the call may denote as well
+        std::unordered_set<unsigned> may_alias;
+    };
+    std::unordered_map<Function *, ProcedureFacts> procedure_facts_;
+
+    RangeAnalysis ranges_;
+    std::unordered_map<Function *, BasicBlock *> trap_blocks_;          // One shared, out-of-line trap per function
+    unsigned int bounds_checks_emitted_ = 0;
+    unsigned int bounds_checks_eliminated_ = 0;
 
     llvm::Value *value_;
 
+    // Debug information (-g), di_builder_ is only set while the IR is generated
+    std::unique_ptr<DIBuilder> di_builder_;
+    DICompileUnit *di_unit_ = nullptr;
+    DIFile *di_file_ = nullptr;
+    std::vector<DIScope *> di_scopes_;
+    std::unordered_map<const TypeInfo *, DIType *> debug_types_;
+    std::unordered_map<Symbol, DIType *> debug_type_names_;
+
     void init_target_machine();
     void init_builder();
-    void emit();
+    bool emit(raw_pwrite_stream &output, Logger &logger);
+    [[nodiscard]] unsigned int partition_count() const;
+    void emit_bounds_check(llvm::Value *index, int64_t size);
+#ifdef _LLVM_LEGACY
+    [[nodiscard]] Optional<PGOOptions> pgo_options() const;
+#else
+    [[nodiscard]] std::optional<PGOOptions> pgo_options() const;
+#endif
+
+    FunctionType *procedure_type(ProcedureDeclarationNode &node);
+    void declare_imports(ModuleNode &node);
+    static string body_function(const string &module);
+    void declare_attributes(Function *function, ProcedureDeclarationNode &node);
+    static void infer_will_return(Function &function);
+    void infer_noalias();
+    void note_access(llvm::Value *var);
+    bool may_share(Symbol variable, Symbol other);
+
+    void init_debug_info();
+    DIType *debug_type(const std::shared_ptr<TypeInfo> &type);
+    DILocation *debug_location(FilePos pos);
+    void set_debug_location(FilePos pos);
+    void describe_variable(IdentNode &ident, llvm::Value *storage, bool is_global);
 
 public:
-    CodeGenerator(string filename, OutputFileType output_type);
+    CodeGenerator(string filename, CodeGenOptions options);
 
     void visit(ExpressionNode &) override;
     void visit(BinaryExpressionNode &) override;
@@ -80,13 +191,14 @@ public:
     void visit(SelectorNode &) override;
 
     llvm::Type* create_llvm_type(std::shared_ptr<TypeInfo>);
-    llvm::Type* lookup_or_create_llvm_type(std::shared_ptr<TypeInfo> type);
+    llvm::Type* lookup_or_create_llvm_type(const std::shared_ptr<TypeInfo> &type);
 
     void visit(TypeNode &) override;
     void visit(ArrayTypeNode &) override;
     void visit(PointerTypeNode &) override;
     void visit(DeclarationsNode &) override;
     void create_declarations(DeclarationsNode &node, bool is_global = false);
+    llvm::Value *constant_value(ExpressionNode &expr, llvm::Type *type);
     void visit(ProcedureDeclarationNode &) override;
     void visit(RecordTypeNode &) override;
 
@@ -101,7 +213,34 @@ public:
 
     void visit(ModuleNode &) override;
 
-    void generate_code(ModuleNode &);
+    // generate_code runs all of the following steps, they are exposed individually so that the driver can time them
+    bool generate_code(ModuleNode &, Logger &logger);
+    void generate_ir(ModuleNode &);
+    void optimize();
+    // the emit functions report errors (e.g. an unwritable output file) to the logger and return false
+    // writes the output file next to the source file
+    bool emit(Logger &logger);
+    // writes the output (in the requested format) into the given buffer instead of a file
+    bool emit(SmallVectorImpl<char> &buffer, Logger &logger);
+    // writes object code into one buffer per partition of the module (see CodeGenOptions::codegen_jobs)
+    bool emit(std::vector<SmallVector<char, 0>> &objects, Logger &logger);
+    // name of the file written by emit() for the given source file
+    static string output_file(const string &filename, OutputFileType type);
+    // triple of the requested target, "native" is the host and no target the default target triple
+    static string target_triple(const CodeGenOptions &options);
+    // returns false (with a description of the problem in error) if no code can be generated for the requested target
+    static bool check_target(const CodeGenOptions &options, string &error);
+    // whether code for the requested target can be run in-process (no target, "native" or the host's architecture)
+    static bool is_host_target(const CodeGenOptions &options);
+    // links bitcode emitted with CodeGenOptions::whole_program into this generator's (empty) module and makes everything
+    // but main internal, optimize() then runs the link-time pipeline, returns false (after reporting why) on failure
+    bool link_modules(std::vector<std::pair<string, SmallVector<char, 0>>> &bitcode, Logger &logger);
+    // compiles the generated (and optimized) module in-process and executes its main function, main's result is stored in
+    // exit_code, returns false (after reporting why) if the program could not be run
+    bool run(int &exit_code, Logger &logger);
+
+    [[nodiscard]] unsigned int get_emitted_bounds_checks() const;
+    [[nodiscard]] unsigned int get_eliminated_bounds_checks() const;
 };
 
 #endif // OBERON0C_CODEGENERATOR_H
@@ -0,0 +1,131 @@
+//
+// Created by M on 17.10.2026.
+//
+
+#include "ExecutableLinker.h"
+
+#include <llvm/ADT/StringRef.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/FileUtilities.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/Program.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include "config.h"
+
+void ExecutableLinker::add_object(const string &name, llvm::SmallVector<char, 0> object)
+{
+    objects_.emplace_back(name, std::move(object));
+}
+
+string ExecutableLinker::find_driver() const
+{
+    for (auto name : {"clang", "cc", "gcc"})
+    {
+        if (auto path = llvm::sys::findProgramByName(name))
+        {
+            return *path;
+        }
+    }
+    return "";
+}
+
+bool ExecutableLinker::link(const string &output)
+{
+    return run_driver(output, false);
+}
+
+bool ExecutableLinker::combine(const string &output)
+{
+    // nothing to combine, the object is written as is
+    if (objects_.size() == 1)
+    {
+        std::error_code ec;
+        llvm::raw_fd_ostream file(output, ec, llvm::sys::fs::OF_None);
+        if (ec)
+        {
+            logger_.error(output, "Could not write object file: " + ec.message());
+            return false;
+        }
+        file.write(objects_.front().second.data(), objects_.front().second.size());
+        return true;
+    }
+    return run_driver(output, true);
+}
+
+bool ExecutableLinker::run_driver(const string &output, bool relocatable)
+{
+    auto driver = find_driver();
+    if (driver.empty())
+    {
+        logger_.error(output, "No linker found, tried 'clang', 'cc' and 'gcc'.");
+        return false;
+    }
+    if (profile_runtime_ && !relocatable && llvm::sys::path::stem(driver) != "clang")
+    {
+        logger_.error(output, "Linking an instrumented program requires 'clang', found only '" + driver + "'.");
+        return false;
+    }
+
+    // The object code never touches the disk during compilation, but the external linker can only read files.
+    // Each object is therefore written to a temporary file that is removed again once linking is done.
+    std::vector<string> files;
+    std::vector<llvm::FileRemover> removers(objects_.size());
+    for (size_t i = 0; i < objects_.size(); i++)
+    {
+        auto &[name, object] = objects_[i];
+        int fd;
+        llvm::SmallString<128> path;
+        if (auto ec = llvm::sys::fs::createTemporaryFile(llvm::sys::path::stem(name), "o", fd, path))
+        {
+            logger_.error(name, "Could not create temporary object file: " + ec.message());
+            return false;
+        }
+        removers[i].setFile(path);
+        llvm::raw_fd_ostream file(fd, true);
+        file.write(object.data(), object.size());
+        file.close();
+        if (file.has_error())
+        {
+            logger_.error(name, "Could not write temporary object file: " + file.error().message());
+            file.clear_error();
+            return false;
+        }
+        files.emplace_back(path.str());
+    }
+
+    std::vector<llvm::StringRef> args = {driver};
+    if (llvm::sys::findProgramByName("ld.lld"))
+    {
+        args.emplace_back("-fuse-ld=lld");
+    }
+    if (relocatable)
+    {
+        args.emplace_back("-r");
+        args.emplace_back("-nostdlib");
+    }
+    for (auto &file : files)
+    {
+        args.emplace_back(file);
+    }
+    if (!relocatable)
+    {
+        args.emplace_back(OBERON0_RUNTIME);
+        if (profile_runtime_)
+        {
+            args.emplace_back("-fprofile-generate");
+        }
+    }
+    args.emplace_back("-o");
+    args.emplace_back(output);
+
+    string message;
+    logger_.debug((relocatable ? "Combining " : "Linking ") + output + " using " + driver + ".");
+    auto status = llvm::sys::ExecuteAndWait(driver, args, {}, {}, 0, 0, &message);
+    if (status != 0)
+    {
+        logger_.error(output, message.empty() ? "Linker exited with code " + to_string(status) + "." : message);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,43 @@
+//
+// Created by M on 17.10.2026.
+//
+
+#ifndef OBERON0C_EXECUTABLELINKER_H
+#define OBERON0C_EXECUTABLELINKER_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <llvm/ADT/SmallVector.h>
+
+#include "util/Logger.h"
+
+// Links object code emitted into memory together with the Oberon runtime into an executable, or combines it into one object.
+// The system's C compiler driver is used as linker, it is told to use LLD whenever LLD is installed.
+// Instrumented objects (--profile-generate) additionally need the LLVM profile runtime, which only clang provides.
+class ExecutableLinker
+{
+
+private:
+    Logger &logger_;
+    bool profile_runtime_;
+    std::vector<std::pair<string, llvm::SmallVector<char, 0>>> objects_;
+
+    [[nodiscard]] string find_driver() const;
+    bool run_driver(const string &output, bool relocatable);
+
+public:
+    explicit ExecutableLinker(Logger &logger, bool profile_runtime = false) : logger_(logger), profile_runtime_(profile_runtime) {};
+
+    // Adds the object code of a compiled module, the name is only used for diagnostics and temporary files
+    void add_object(const string &name, llvm::SmallVector<char, 0> object);
+
+    // Returns true if the executable was written successfully
+    bool link(const string &output);
+
+    // Combines the objects into a single relocatable object file (partitions of one module), without the runtime
+    bool combine(const string &output);
+};
+
+#endif //OBERON0C_EXECUTABLELINKER_H
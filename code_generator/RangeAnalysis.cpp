@@ -0,0 +1,718 @@
+//
+// Created by M on 17.10.2026.
+//
+
+#include "RangeAnalysis.h"
+
+#include <algorithm>
+#include <limits>
+
+#include <llvm/Support/MathExtras.h>
+
+static constexpr int64_t min_value = std::numeric_limits<int64_t>::min();
+static constexpr int64_t max_value = std::numeric_limits<int64_t>::max();
+
+static std::optional<ValueRange> add(ValueRange a, ValueRange b)
+{
+    ValueRange sum{};
+    if (llvm::AddOverflow(a.lo, b.lo, sum.lo) || llvm::AddOverflow(a.hi, b.hi, sum.hi))
+    {
+        return std::nullopt;
+    }
+    return sum;
+}
+
+static std::optional<ValueRange> negate(ValueRange a)
+{
+    if (a.lo == min_value)
+    {
+        return std::nullopt;
+    }
+    return ValueRange{-a.hi, -a.lo};
+}
+
+static std::optional<ValueRange> multiply(ValueRange a, ValueRange b)
+{
+    int64_t corners[4];
+    if (llvm::MulOverflow(a.lo, b.lo, corners[0]) || llvm::MulOverflow(a.lo, b.hi, corners[1]) ||
+        llvm::MulOverflow(a.hi, b.lo, corners[2]) || llvm::MulOverflow(a.hi, b.hi, corners[3]))
+    {
+        return std::nullopt;
+    }
+    return ValueRange{*std::min_element(corners, corners + 4), *std::max_element(corners, corners + 4)};
+}
+
+bool RangeAnalysis::is_local(Symbol name) const
+{
+    return locals_.count(name) != 0;
+}
+
+std::optional<Symbol> RangeAnalysis::plain_variable(ExpressionNode &expr)
+{
+    if (expr.getNodeType() != NodeType::ident_selector_expression)
+    {
+        return std::nullopt;
+    }
+
+    auto &id_expr = dynamic_cast<IdentSelectorExpressionNode &>(expr);
+    auto selector = id_expr.get_selector();
+    if (selector && selector->get_selector() && !selector->get_selector()->empty())
+    {
+        return std::nullopt;
+    }
+    return id_expr.get_identifier()->get_symbol();
+}
+
+std::optional<int64_t> RangeAnalysis::constant_of(ExpressionNode &expr) const
+{
+    if (auto value = expr.get_value())
+    {
+        return value;
+    }
+    if (expr.getNodeType() == NodeType::integer)
+    {
+        return dynamic_cast<IntNode &>(expr).get_value();
+    }
+    if (auto name = plain_variable(expr))
+    {
+        auto constant = constants_.find(*name);
+        if (constant != constants_.end())
+        {
+            return constant->second;
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<ValueRange> RangeAnalysis::range_of(ExpressionNode &expr) const
+{
+    if (auto value = constant_of(expr))
+    {
+        return ValueRange{*value, *value};
+    }
+
+    switch (expr.getNodeType())
+    {
+    case NodeType::ident_selector_expression:
+    {
+        auto name = plain_variable(expr);
+        if (!name)
+        {
+            return std::nullopt;
+        }
+        auto fact = facts_.find(*name);
+        return (fact == facts_.end()) ? std::nullopt : std::optional<ValueRange>(fact->second);
+    }
+    case NodeType::unary_expression:
+    {
+        auto &unary = dynamic_cast<UnaryExpressionNode &>(expr);
+        auto inner = range_of(*unary.get_expr());
+        if (!inner)
+        {
+            return std::nullopt;
+        }
+        switch (unary.get_op())
+        {
+        case SourceOperator::PAREN:
+        case SourceOperator::NO_OPERATOR:
+            return inner;
+        case SourceOperator::NEG:
+            return negate(*inner);
+        default:
+            return std::nullopt;
+        }
+    }
+    case NodeType::binary_expression:
+    {
+        auto &binary = dynamic_cast<BinaryExpressionNode &>(expr);
+        auto lhs = range_of(*binary.get_lhs());
+        auto rhs = range_of(*binary.get_rhs());
+        if (!lhs || !rhs)
+        {
+            return std::nullopt;
+        }
+        switch (binary.get_op())
+        {
+        case SourceOperator::PLUS:
+            return add(*lhs, *rhs);
+        case SourceOperator::MINUS:
+        {
+            auto negated = negate(*rhs);
+            return negated ? add(*lhs, *negated) : std::nullopt;
+        }
+        case SourceOperator::MULT:
+            return multiply(*lhs, *rhs);
+        default:
+            return std::nullopt;
+        }
+    }
+    default:
+        return std::nullopt;
+    }
+}
+
+void RangeAnalysis::declare_constant(Symbol name, ExpressionNode &value)
+{
+    facts_.erase(name);
+    locals_.erase(name);
+    if (auto constant = constant_of(value))
+    {
+        constants_[name] = *constant;
+    }
+    else
+    {
+        constants_.erase(name);
+    }
+}
+
+void RangeAnalysis::declare_variable(Symbol name, bool local, bool var_parameter)
+{
+    facts_.erase(name);
+    constants_.erase(name);
+    if (var_parameter)
+    {
+        var_parameters_.insert(name);
+    }
+    else
+    {
+        var_parameters_.erase(name);
+    }
+    if (local)
+    {
+        locals_.insert(name);
+    }
+    else
+    {
+        locals_.erase(name);
+    }
+}
+
+RangeAnalysis::ProcedureState RangeAnalysis::enter_procedure()
+{
+    ProcedureState state{facts_, constants_, locals_, var_parameters_};
+
+    // A procedure may be called from anywhere, nothing is known about the variables of the enclosing scopes
+    facts_.clear();
+    locals_.clear();
+    var_parameters_.clear();
+    return state;
+}
+
+void RangeAnalysis::leave_procedure(ProcedureState state)
+{
+    facts_ = std::move(state.facts);
+    constants_ = std::move(state.constants);
+    locals_ = std::move(state.locals);
+    var_parameters_ = std::move(state.var_parameters);
+}
+
+void RangeAnalysis::forget_non_locals()
+{
+    for (auto itr = facts_.begin(); itr != facts_.end();)
+    {
+        if (!is_local(itr->first))
+        {
+            itr = facts_.erase(itr);
+        }
+        else
+        {
+            itr++;
+        }
+    }
+}
+
+void RangeAnalysis::forget_var_parameters()
+{
+    for (auto name : var_parameters_)
+    {
+        facts_.erase(name);
+    }
+}
+
+void RangeAnalysis::assign(IdentNode &variable, SelectorNode *selector, ExpressionNode &expr)
+{
+    auto name = variable.get_symbol();
+
+    // An element or field of a global variable may be what a VAR parameter refers to, one written through a VAR
+    // parameter may belong to any non-local variable
+    if (selector && selector->get_selector() && !selector->get_selector()->empty())
+    {
+        if (var_parameters_.count(name))
+        {
+            forget_non_locals();
+        }
+        else if (!is_local(name))
+        {
+            forget_var_parameters();
+        }
+        return;
+    }
+
+    auto range = range_of(expr);
+
+    // Non-local variables may be aliased through VAR parameters
+    if (!is_local(name))
+    {
+        forget_non_locals();
+    }
+
+    if (range)
+    {
+        facts_[name] = *range;
+    }
+    else
+    {
+        facts_.erase(name);
+    }
+}
+
+std::vector<Symbol> RangeAnalysis::var_arguments(ProcedureCallNode &call)
+{
+    std::vector<Symbol> arguments;
+    auto declaration = call.get_declaration();
+    auto actual_parameters = call.get_parameters();
+    if (!declaration || !declaration->get_parameters() || !actual_parameters)
+    {
+        return arguments;
+    }
+
+    auto act_itr = actual_parameters->begin();
+    for (auto &formal : *declaration->get_parameters())
+    {
+        bool is_var = std::get<0>(*formal);
+        for (size_t i = 0; i < std::get<1>(*formal)->size() && act_itr != actual_parameters->end(); i++, act_itr++)
+        {
+            if (is_var && (*act_itr)->getNodeType() == NodeType::ident_selector_expression)
+            {
+                arguments.push_back(dynamic_cast<IdentSelectorExpressionNode &>(**act_itr).get_identifier()->get_symbol());
+            }
+        }
+    }
+    return arguments;
+}
+
+void RangeAnalysis::call(ProcedureCallNode &call)
+{
+    forget_non_locals();
+    for (auto name : var_arguments(call))
+    {
+        facts_.erase(name);
+    }
+}
+
+RangeFacts RangeAnalysis::facts() const
+{
+    return facts_;
+}
+
+void RangeAnalysis::restore(RangeFacts facts)
+{
+    facts_ = std::move(facts);
+}
+
+void RangeAnalysis::assume(ExpressionNode &condition)
+{
+    // Conjuncts are evaluated from left to right, a call in a later conjunct could invalidate an earlier one
+    Effects effects;
+    collect_effects(&condition, effects);
+    if (effects.calls)
+    {
+        return;
+    }
+
+    std::vector<ExpressionNode *> pending = {&condition};
+    while (!pending.empty())
+    {
+        auto expr = pending.back();
+        pending.pop_back();
+
+        if (expr->getNodeType() == NodeType::unary_expression)
+        {
+            auto &unary = dynamic_cast<UnaryExpressionNode &>(*expr);
+            if (unary.get_op() == SourceOperator::PAREN || unary.get_op() == SourceOperator::NO_OPERATOR)
+            {
+                pending.push_back(unary.get_expr());
+            }
+            continue;
+        }
+        if (expr->getNodeType() != NodeType::binary_expression)
+        {
+            continue;
+        }
+
+        auto &binary = dynamic_cast<BinaryExpressionNode &>(*expr);
+        auto op = binary.get_op();
+        if (op == SourceOperator::AND)
+        {
+            pending.push_back(binary.get_lhs());
+            pending.push_back(binary.get_rhs());
+            continue;
+        }
+
+        // Normalize to 'variable op bound'
+        auto variable = plain_variable(*binary.get_lhs());
+        auto bound = range_of(*binary.get_rhs());
+        if (!variable || !bound)
+        {
+            variable = plain_variable(*binary.get_rhs());
+            bound = range_of(*binary.get_lhs());
+            switch (op)
+            {
+            case SourceOperator::LT: op = SourceOperator::GT; break;
+            case SourceOperator::LEQ: op = SourceOperator::GEQ; break;
+            case SourceOperator::GT: op = SourceOperator::LT; break;
+            case SourceOperator::GEQ: op = SourceOperator::LEQ; break;
+            default: break;
+            }
+        }
+        if (!variable || !bound || constants_.count(*variable))
+        {
+            continue;
+        }
+
+        auto fact = facts_.find(*variable);
+        ValueRange range = (fact == facts_.end()) ? ValueRange{min_value, max_value} : fact->second;
+        switch (op)
+        {
+        case SourceOperator::LT:
+            if (bound->hi == min_value) continue;
+            range.hi = std::min(range.hi, bound->hi - 1);
+            break;
+        case SourceOperator::LEQ:
+            range.hi = std::min(range.hi, bound->hi);
+            break;
+        case SourceOperator::GT:
+            if (bound->lo == max_value) continue;
+            range.lo = std::max(range.lo, bound->lo + 1);
+            break;
+        case SourceOperator::GEQ:
+            range.lo = std::max(range.lo, bound->lo);
+            break;
+        case SourceOperator::EQ:
+            range.lo = std::max(range.lo, bound->lo);
+            range.hi = std::min(range.hi, bound->hi);
+            break;
+        default:
+            continue;
+        }
+
+        // An empty range means the code is unreachable, it is simply not refined any further
+        if (range.lo <= range.hi)
+        {
+            facts_[*variable] = range;
+        }
+    }
+}
+
+void RangeAnalysis::join(const std::vector<RangeFacts> &branches)
+{
+    if (branches.empty())
+    {
+        return;
+    }
+
+    RangeFacts joined;
+    for (auto &[name, range] : branches.front())
+    {
+        ValueRange merged = range;
+        bool everywhere = true;
+        for (size_t i = 1; i < branches.size() && everywhere; i++)
+        {
+            auto other = branches[i].find(name);
+            if (other == branches[i].end())
+            {
+                everywhere = false;
+            }
+            else
+            {
+                merged.lo = std::min(merged.lo, other->second.lo);
+                merged.hi = std::max(merged.hi, other->second.hi);
+            }
+        }
+        if (everywhere)
+        {
+            joined[name] = merged;
+        }
+    }
+    facts_ = std::move(joined);
+}
+
+// Returns c if the assignment 'target := expr' is 'target := target + c' (or an equivalent form) for a constant c
+std::optional<int64_t> RangeAnalysis::step_of(Symbol target, ExpressionNode &expr) const
+{
+    if (expr.getNodeType() != NodeType::binary_expression)
+    {
+        return std::nullopt;
+    }
+
+    auto &binary = dynamic_cast<BinaryExpressionNode &>(expr);
+    auto lhs = plain_variable(*binary.get_lhs());
+    auto rhs = plain_variable(*binary.get_rhs());
+    std::optional<int64_t> step;
+
+    if (lhs && *lhs == target)
+    {
+        step = constant_of(*binary.get_rhs());
+        if (step && binary.get_op() == SourceOperator::MINUS)
+        {
+            step = (*step == min_value) ? std::nullopt : std::optional<int64_t>(-*step);
+        }
+        else if (binary.get_op() != SourceOperator::PLUS)
+        {
+            step = std::nullopt;
+        }
+    }
+    else if (rhs && *rhs == target && binary.get_op() == SourceOperator::PLUS)
+    {
+        step = constant_of(*binary.get_lhs());
+    }
+    return step;
+}
+
+void RangeAnalysis::collect_effects(ProcedureCallNode &call, Effects &effects) const
+{
+    effects.calls = true;
+    for (auto name : var_arguments(call))
+    {
+        effects.var_arguments.insert(name);
+    }
+    if (auto parameters = call.get_parameters())
+    {
+        for (auto &parameter : *parameters)
+        {
+            collect_effects(parameter.get(), effects);
+        }
+    }
+}
+
+void RangeAnalysis::collect_effects(ExpressionNode *expr, Effects &effects) const
+{
+    if (!expr)
+    {
+        return;
+    }
+
+    switch (expr->getNodeType())
+    {
+    case NodeType::unary_expression:
+        collect_effects(dynamic_cast<UnaryExpressionNode *>(expr)->get_expr(), effects);
+        break;
+    case NodeType::binary_expression:
+        collect_effects(dynamic_cast<BinaryExpressionNode *>(expr)->get_lhs(), effects);
+        collect_effects(dynamic_cast<BinaryExpressionNode *>(expr)->get_rhs(), effects);
+        break;
+    case NodeType::ident_selector_expression:
+    {
+        auto selector = dynamic_cast<IdentSelectorExpressionNode *>(expr)->get_selector();
+        if (selector && selector->get_selector())
+        {
+            for (auto &[is_array, ident, index] : *selector->get_selector())
+            {
+                if (is_array)
+                {
+                    collect_effects(index, effects);
+                }
+            }
+        }
+        break;
+    }
+    case NodeType::procedure_call:
+        collect_effects(*dynamic_cast<ProcedureCallExpressionNode *>(expr)->get_call(), effects);
+        break;
+    default:
+        break;
+    }
+}
+
+void RangeAnalysis::collect_effects(StatementSequenceNode *statements, Effects &effects) const
+{
+    if (!statements || !statements->get_statements())
+    {
+        return;
+    }
+
+    for (auto &statement : *statements->get_statements())
+    {
+        switch (statement->getNodeType())
+        {
+        case NodeType::assignment:
+        {
+            auto &assignment = dynamic_cast<AssignmentNode &>(*statement);
+            auto selector = assignment.get_selector();
+            if (selector && selector->get_selector())
+            {
+                for (auto &[is_array, ident, index] : *selector->get_selector())
+                {
+                    if (is_array)
+                    {
+                        collect_effects(index, effects);
+                    }
+                }
+            }
+            collect_effects(assignment.get_expr(), effects);
+
+            if (!selector || !selector->get_selector() || selector->get_selector()->empty())
+            {
+                auto name = assignment.get_variable()->get_symbol();
+                auto step = step_of(name, *assignment.get_expr());
+                auto direction = step ? ((*step >= 0) ? 1 : -1) : 0;
+                if (step)
+                {
+                    // saturates, a step this large keeps no bound anyway
+                    auto &total = effects.steps[name];
+                    if (llvm::AddOverflow(total, (*step >= 0) ? *step : -*step, total))
+                    {
+                        total = max_value;
+                    }
+                }
+                auto previous = effects.writes.find(name);
+                if (previous == effects.writes.end())
+                {
+                    effects.writes[name] = direction;
+                }
+                else if (previous->second != direction)
+                {
+                    previous->second = 0;
+                }
+            }
+            else if (var_parameters_.count(assignment.get_variable()->get_symbol()))
+            {
+                // as in assign(), an arbitrary non-local write
+                effects.writes[assignment.get_variable()->get_symbol()] = 0;
+            }
+            else if (!is_local(assignment.get_variable()->get_symbol()))
+            {
+                effects.element_writes = true;
+            }
+            break;
+        }
+        case NodeType::procedure_call:
+            collect_effects(dynamic_cast<ProcedureCallNode &>(*statement), effects);
+            break;
+        case NodeType::if_statement:
+        {
+            auto &if_statement = dynamic_cast<IfStatementNode &>(*statement);
+            collect_effects(if_statement.get_condition(), effects);
+            collect_effects(if_statement.get_then(), effects);
+            if (auto else_ifs = if_statement.get_else_ifs())
+            {
+                for (auto &[condition, branch] : *else_ifs)
+                {
+                    collect_effects(condition.get(), effects);
+                    collect_effects(branch.get(), effects);
+                }
+            }
+            collect_effects(if_statement.get_else(), effects);
+            break;
+        }
+        case NodeType::while_statement:
+            collect_loop_effects(dynamic_cast<WhileStatementNode &>(*statement).get_statements(),
+                                 dynamic_cast<WhileStatementNode &>(*statement).get_expr(), effects);
+            break;
+        case NodeType::repeat_statement:
+            collect_loop_effects(dynamic_cast<RepeatStatementNode &>(*statement).get_statements(),
+                                 dynamic_cast<RepeatStatementNode &>(*statement).get_expr(), effects);
+            break;
+        case NodeType::return_statement:
+            collect_effects(dynamic_cast<ReturnStatementNode &>(*statement).get_value(), effects);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+// A nested loop may run any number of times per iteration of the enclosing loop, so the total change of its increments
+// is not bounded
+void RangeAnalysis::collect_loop_effects(StatementSequenceNode *body, ExpressionNode *condition, Effects &effects) const
+{
+    Effects nested;
+    collect_effects(condition, nested);
+    collect_effects(body, nested);
+
+    for (auto &[name, direction] : nested.writes)
+    {
+        effects.writes[name] = 0;
+    }
+    effects.var_arguments.insert(nested.var_arguments.begin(), nested.var_arguments.end());
+    effects.calls = effects.calls || nested.calls;
+    effects.element_writes = effects.element_writes || nested.element_writes;
+}
+
+RangeFacts RangeAnalysis::loop_head(StatementSequenceNode *body, ExpressionNode *condition, bool guarded)
+{
+    Effects effects;
+    collect_effects(body, effects);
+    collect_effects(condition, effects);
+
+    size_t non_local_writes = 0;
+    for (auto &[name, direction] : effects.writes)
+    {
+        non_local_writes += !is_local(name);
+    }
+
+    // Facts from before the loop remain valid at its head if no iteration can invalidate them.
+    // Variables that are only incremented (decremented) keep their lower (upper) bound.
+    RangeFacts head;
+    for (auto &[name, range] : facts_)
+    {
+        if (effects.var_arguments.count(name) || (!is_local(name) && (effects.calls || non_local_writes > 1)) ||
+            (effects.element_writes && var_parameters_.count(name)))
+        {
+            continue;
+        }
+
+        auto write = effects.writes.find(name);
+        if (write == effects.writes.end())
+        {
+            if (is_local(name) || non_local_writes == 0)
+            {
+                head[name] = range;
+            }
+        }
+        else if (write->second > 0)
+        {
+            head[name] = {range.lo, max_value};
+        }
+        else if (write->second < 0)
+        {
+            head[name] = {min_value, range.hi};
+        }
+    }
+
+    // An increment cannot wrap around as long as the variable is bounded whenever the body is entered and the increments
+    // of one iteration cannot take it past the largest integer, otherwise its bound from before the loop does not hold.
+    // Dropping a bound may invalidate the condition's bound of another variable, hence this is repeated until none is dropped.
+    for (bool dropped = true; dropped;)
+    {
+        dropped = false;
+        facts_ = head;
+        if (guarded && condition)
+        {
+            assume(*condition);
+        }
+
+        for (auto &[name, direction] : effects.writes)
+        {
+            auto fact = head.find(name);
+            if (direction == 0 || fact == head.end())
+            {
+                continue;
+            }
+
+            auto bound = facts_.find(name);
+            int64_t limit;
+            bool wraps = !guarded || bound == facts_.end() ||
+                         (direction > 0 ? llvm::AddOverflow(bound->second.hi, effects.steps[name], limit)
+                                        : llvm::SubOverflow(bound->second.lo, effects.steps[name], limit));
+            if (wraps)
+            {
+                head.erase(fact);
+                dropped = true;
+            }
+        }
+    }
+
+    facts_ = head;
+    return head;
+}
@@ -0,0 +1,96 @@
+//
+// Created by M on 17.10.2026.
+//
+
+#ifndef OBERON0C_RANGEANALYSIS_H
+#define OBERON0C_RANGEANALYSIS_H
+
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "util/Symbol.h"
+#include "util/datastructures/ast/NodeVisitor.h"
+
+// Closed interval of values an INTEGER expression can take
+struct ValueRange {
+    int64_t lo;
+    int64_t hi;
+};
+
+typedef std::unordered_map<Symbol, ValueRange> RangeFacts;
+
+// Tracks value ranges of INTEGER variables while the code generator walks the statements of a procedure.
+// The code generator reports every assignment, call and control flow construct in the order in which it generates code,
+// the analysis then knows which ranges hold at the current insertion point. It is used to prove array indices in bounds.
+//
+// Facts are derived from constants, assignments, increments of loop induction variables and WHILE/IF conditions.
+// Calls may modify all non-local variables as well as the VAR arguments passed to them. Assignments to non-local variables
+// may modify other non-local variables through VAR parameters. Both are handled by forgetting the affected facts.
+class RangeAnalysis {
+
+private:
+    struct Effects {
+        std::unordered_map<Symbol, int> writes;     // direction of all writes: 1 only increments, -1 only decrements, 0 arbitrary
+        std::unordered_map<Symbol, int64_t> steps;  // largest total change of the increments (decrements) in one iteration
+        std::unordered_set<Symbol> var_arguments;
+        bool calls = false;
+        bool element_writes = false;                // elements or fields of global variables are written
+    };
+
+    struct ProcedureState {
+        RangeFacts facts;
+        std::unordered_map<Symbol, int64_t> constants;
+        std::unordered_set<Symbol> locals;
+        std::unordered_set<Symbol> var_parameters;
+    };
+
+    RangeFacts facts_;
+    std::unordered_map<Symbol, int64_t> constants_;
+    std::unordered_set<Symbol> locals_;     // variables and value parameters of the current procedure
+    std::unordered_set<Symbol> var_parameters_;
+
+    [[nodiscard]] bool is_local(Symbol name) const;
+    [[nodiscard]] std::optional<int64_t> constant_of(ExpressionNode &expr) const;
+    [[nodiscard]] std::optional<int64_t> step_of(Symbol target, ExpressionNode &expr) const;
+
+    void forget_non_locals();
+    void forget_var_parameters();
+    void collect_effects(StatementSequenceNode *statements, Effects &effects) const;
+    void collect_effects(ExpressionNode *expr, Effects &effects) const;
+    void collect_effects(ProcedureCallNode &call, Effects &effects) const;
+    void collect_loop_effects(StatementSequenceNode *body, ExpressionNode *condition, Effects &effects) const;
+
+    static std::optional<Symbol> plain_variable(ExpressionNode &expr);
+    static std::vector<Symbol> var_arguments(ProcedureCallNode &call);
+
+public:
+    RangeAnalysis() = default;
+
+    // Returns the range of the expression's value under the current facts, or nullopt if it is unknown
+    [[nodiscard]] std::optional<ValueRange> range_of(ExpressionNode &expr) const;
+
+    // Declarations
+    void declare_constant(Symbol name, ExpressionNode &value);
+    void declare_variable(Symbol name, bool local, bool var_parameter = false);
+    ProcedureState enter_procedure();
+    void leave_procedure(ProcedureState state);
+
+    // Statements, reported after the code for them has been generated
+    void assign(IdentNode &variable, SelectorNode *selector, ExpressionNode &expr);
+    void call(ProcedureCallNode &call);
+
+    // Control flow
+    [[nodiscard]] RangeFacts facts() const;
+    void restore(RangeFacts facts);
+    void assume(ExpressionNode &condition);
+    void join(const std::vector<RangeFacts> &branches);
+
+    // Replaces the facts by those holding at the head of a loop with the given body and condition, which are also returned.
+    // The condition of a guarded loop (WHILE) holds whenever the body is entered.
+    RangeFacts loop_head(StatementSequenceNode *body, ExpressionNode *condition, bool guarded);
+};
+
+#endif //OBERON0C_RANGEANALYSIS_H
@@ -8,17 +8,19 @@
 #define OBERON_LLVM_GLOBAL_H
 
 
+#include <cstdint>
 #include <sstream>
 #include <string>
 
-using std::streampos;
 using std::string;
 using std::stringstream;
 
+// Identifies a source file registered with the SourceManager (0 = no file)
+using FileId = uint32_t;
+
+// Offset into the SourceManager's global offset space (0 = no position), see SourceManager::resolve
 struct FilePos {
-    string fileName;
-    int lineNo, charNo;
-    streampos offset;
+    uint32_t offset;
 };
 
 template <typename T>
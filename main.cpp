@@ -4,19 +4,434 @@
  * Created by Michael Grossniklaus on 12/14/17.
  */
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <iomanip>
 #include <iostream>
+#include <mutex>
+#include <sstream>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 #include "util/command_line_options.hpp"
+#include "util/Arena.h"
 #include "scanner/Scanner.h"
 #include "parser/Parser.h"
 #include "semantic_checker/SemanticChecker.h"
+#include "semantic_checker/SymbolFile.h"
+#include "semantic_checker/ExpressionFolder.h"
 #include "code_generator/CodeGenerator.h"
+#include "code_generator/ExecutableLinker.h"
+#include "util/CompilationCache.h"
+#include <llvm/Support/SHA1.h>
 
 using std::cerr;
 using std::cout;
 using std::endl;
 using std::string;
 
+using Clock = std::chrono::steady_clock;
+
+// Reference point for reporting the time until the first IR is available
+static const Clock::time_point process_start = Clock::now();
+
+// Settings shared by all compilations of one invocation
+struct DriverOptions {
+    LogLevel log_level;
+    bool print;
+    bool run;
+    bool timing;
+    // executable to link, empty if the output of each compilation is written to a file of its own
+    string output;
+    // searched for symbol files of imported modules after the directory of the importing source file
+    std::vector<string> import_paths;
+    CodeGenOptions codegen;
+    // outputs of earlier compilations (--cache-dir), configuration describes all options that influence the output
+    CompilationCache *cache = nullptr;
+    string configuration;
+};
+
+// Records the duration of the phases of one compilation (--timing)
+class PhaseTimer {
+
+private:
+    bool enabled_;
+    Clock::time_point last_;
+    std::vector<std::pair<string, double>> phases_;
+    double first_ir_ = -1;
+
+    static double ms_since(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+public:
+    explicit PhaseTimer(bool enabled) : enabled_(enabled), last_(Clock::now()) {};
+
+    void phase(const string &name) {
+        if(enabled_){
+            phases_.emplace_back(name, ms_since(last_));
+            last_ = Clock::now();
+        }
+    }
+
+    void first_ir() {
+        if(enabled_){
+            first_ir_ = ms_since(process_start);
+        }
+    }
+
+    void report(const string &filename, ostream &out) const {
+        if(!enabled_){
+            return;
+        }
+        out << "Timing for " << filename << ":" << std::endl << std::fixed << std::setprecision(3);
+        for(auto &[name, ms] : phases_){
+            out << "  " << std::left << std::setw(20) << name << std::right << std::setw(10) << ms << " ms" << std::endl;
+        }
+        if(first_ir_ >= 0){
+            out << "  " << std::left << std::setw(20) << "time to first IR" << std::right << std::setw(10) << first_ir_ << " ms" << std::endl;
+        }
+    }
+};
+
+// Outcome of compiling a single file, diagnostics are buffered so that they can be reported in input order
+struct CompilationResult {
+    std::stringstream out, err;
+    std::vector<llvm::SmallVector<char, 0>> objects;
+    bool failed = false;
+    int exit_code = 0;
+};
+
+static void report_status(Logger &logger) {
+    string status = (logger.getErrorCount() == 0 ? "complete" : "failed");
+    logger.info("Compilation " + status + ": " +
+                to_string(logger.getErrorCount()) + " error(s), " +
+                to_string(logger.getWarningCount()) + " warning(s), " +
+                to_string(logger.getInfoCount()) + " message(s).", true);
+}
+
+// Name and imports of a module, read from the beginning of its source without parsing the rest
+struct ModuleHeader {
+    string name;
+    std::vector<string> imports;
+};
+
+static ModuleHeader read_header(const string &filename) {
+    ModuleHeader header;
+    auto buffer = llvm::MemoryBuffer::getFile(filename, false, false);
+    if(!buffer){
+        return header;
+    }
+
+    // only the first few tokens are scanned, the source is not registered with the SourceManager
+    std::stringstream diagnostics;
+    Logger logger(LogLevel::QUIET, diagnostics);
+    const std::filesystem::path path(filename);
+    Scanner scanner(path, **buffer, logger);
+
+    if(scanner.next().type() != TokenType::kw_module || scanner.peek().type() != TokenType::const_ident){
+        return header;
+    }
+    header.name = scanner.next().symbol().str();
+    if(scanner.next().type() != TokenType::semicolon || scanner.peek().type() != TokenType::kw_import){
+        return header;
+    }
+    scanner.next();
+    do{
+        if(scanner.peek().type() != TokenType::const_ident){
+            break;
+        }
+        header.imports.push_back(scanner.next().symbol().str());
+    }while(scanner.next().type() == TokenType::comma);
+    return header;
+}
+
+static string source_directory(const string &filename) {
+    auto directory = llvm::sys::path::parent_path(filename);
+    return directory.empty() ? "." : directory.str();
+}
+
+// Symbol files of all interfaces a module depends on (imported directly or referred to by imported interfaces)
+static string interface_configuration(const ModuleHeader &header, const std::vector<string> &import_paths) {
+    string configuration = ";imports=";
+    std::vector<Symbol> pending(header.imports.begin(), header.imports.end());
+    std::unordered_set<Symbol> seen;
+    while(!pending.empty()){
+        auto module = pending.back();
+        pending.pop_back();
+        if(!seen.insert(module).second){
+            continue;
+        }
+        auto path = SymbolFile::find(module, import_paths);
+        auto file = llvm::MemoryBuffer::getFile(path, false, false);
+        configuration += module.str() + ":" + (file ? llvm::toHex(llvm::SHA1::hash(llvm::arrayRefFromStringRef((*file)->getBuffer())), true) : "") + ",";
+
+        std::vector<Symbol> imports;
+        if(SymbolFile::read_imports(path, imports)){
+            pending.insert(pending.end(), imports.begin(), imports.end());
+        }
+    }
+    return configuration;
+}
+
+// Describes everything besides the source that influences the generated code, "native" is resolved to the host
+static string cache_configuration(const CodeGenOptions &options) {
+    std::stringstream configuration;
+    configuration << "type=" << static_cast<int>(options.output_type) << ";O=" << static_cast<int>(options.opt_level);
+    configuration << ";target=" << (options.target_triple == "native" ? llvm::sys::getProcessTriple() : options.target_triple);
+    configuration << ";cpu=" << (options.cpu == "native" ? llvm::sys::getHostCPUName().str() : options.cpu);
+    configuration << ";features=";
+    if(options.features == "native"){
+        llvm::StringMap<bool> features;
+        llvm::sys::getHostCPUFeatures(features);
+        std::vector<string> enabled;
+        for(auto &feature : features){
+            enabled.push_back((feature.second ? "+" : "-") + feature.first().str());
+        }
+        std::sort(enabled.begin(), enabled.end());
+        for(auto &feature : enabled){
+            configuration << feature << ",";
+        }
+    }else{
+        configuration << options.features;
+    }
+    configuration << ";pic=" << options.position_independent << ";bounds=" << options.bounds_check << ";runtime=" << options.runtime << ";g=" << options.debug_info;
+    configuration << ";split=" << (options.codegen_jobs > 0) << ";profile-generate=" << options.profile_generate;
+    configuration << ";whole-program=" << options.whole_program;
+    if(!options.profile_use.empty()){
+        auto profile = llvm::MemoryBuffer::getFile(options.profile_use);
+        configuration << ";profile-use=" << (profile ? llvm::toHex(llvm::SHA1::hash(llvm::arrayRefFromStringRef((*profile)->getBuffer())), true) : "");
+    }
+    return configuration.str();
+}
+
+// If objects is given, the generated code is emitted into it (one object per partition) instead of being written to a file
+static void compile(const string &filename, const ModuleHeader &header, const DriverOptions &options, Logger &logger,
+                    ostream &out, int &exit_code, std::vector<llvm::SmallVector<char, 0>> *objects = nullptr) {
+
+    PhaseTimer timer(options.timing);
+
+    // Symbol files are written next to the source, which is also the first place where imported ones are searched
+    auto directory = source_directory(filename);
+    std::vector<string> import_paths{directory};
+    import_paths.insert(import_paths.end(), options.import_paths.begin(), options.import_paths.end());
+
+    // On a cache hit, the cached output replaces the whole compilation, the last output of an entry is the symbol file
+    string cache_key;
+    if(options.cache && !options.run){
+        cache_key = options.cache->key(filename, options.configuration + (objects ? ";objects" : ";file") + interface_configuration(header, import_paths));
+        std::vector<llvm::SmallVector<char, 0>> cached;
+        if(!cache_key.empty() && options.cache->lookup(cache_key, cached) && !cached.empty()){
+            logger.info("Using cached output.", true);
+            auto symbols = std::move(cached.back());
+            cached.pop_back();
+            if(!symbols.empty()){
+                llvm::SmallString<128> symbol_file(directory);
+                llvm::sys::path::append(symbol_file, SymbolFile::file_name(header.name));
+                SymbolFile::write(string(symbol_file), llvm::StringRef(symbols.data(), symbols.size()), logger);
+            }
+            if(objects){
+                *objects = std::move(cached);
+            }else if(!cached.empty()){
+                auto output_file = CodeGenerator::output_file(filename, options.codegen.output_type);
+                std::error_code ec;
+                llvm::raw_fd_ostream output(output_file, ec, llvm::sys::fs::OF_None);
+                if(ec){
+                    logger.error(output_file, "Could not write output file: " + ec.message());
+                }else{
+                    output.write(cached.front().data(), cached.front().size());
+                }
+            }
+            timer.phase("cache lookup");
+            timer.report(filename, out);
+            report_status(logger);
+            return;
+        }
+    }
+
+    // All AST nodes are allocated in this arena, it has to outlive the AST
+    Arena arena;
+
+    // Scanning
+    logger.info("Starting scanning...",true);
+    Scanner scanner(filename, logger);
+    if(logger.getErrorCount() > 0){
+        report_status(logger);
+        return;
+    }
+    logger.info("Scanning successful. Starting Parsing...",true);
+
+    // Parsing
+    Parser parser(scanner,logger);
+    auto ast = parser.parse();
+    timer.phase("scanning+parsing");
+    if(ast && logger.getErrorCount() == 0){
+
+        if(options.print){
+            out << "Compiled Program:" << std::endl << *ast << std::endl;
+        }
+
+        logger.info("Parsing successful. Starting semantic checking...", true);
+
+        // Semantic Checking
+        SemanticChecker semantics(logger, import_paths);
+        semantics.validate_program(*ast);
+
+        // importers only need the interface of a module, which is known once the module has been checked
+        llvm::SmallString<128> symbol_file;
+        if(logger.getErrorCount() == 0 && ast->has_exports()){
+            symbol_file = directory;
+            llvm::sys::path::append(symbol_file, SymbolFile::file_name(ast->get_name().first->get_symbol()));
+            SymbolFile::write(*ast, string(symbol_file), logger);
+        }
+        if(logger.getErrorCount() == 0 && options.run && (ast->has_exports() || !ast->get_imports().empty())){
+            logger.error(filename, "Only modules that neither import nor export declarations can be run in-process, link them with '-o' instead.");
+        }
+        timer.phase("semantic checking");
+
+        if(logger.getErrorCount() > 0){
+            logger.info("Errors occurred during semantic checking.", true);
+        }
+        else{
+
+            // constant subexpressions reach the code generator as literals
+            ExpressionFolder folder;
+            folder.fold_constants(*ast);
+            timer.phase("constant folding");
+            if(folder.get_folded() > 0){
+                logger.debug("Constant folding replaced " + to_string(folder.get_folded()) + " expression(s) by literals.", true);
+            }
+
+            logger.info("Semantic checking successful. Starting code generation...", true);
+
+            // Code Generation
+            CodeGenerator code_gen(filename,options.codegen);
+            timer.phase("target setup");
+            code_gen.generate_ir(*ast);
+            timer.phase("IR generation");
+            timer.first_ir();
+            if(options.codegen.bounds_check){
+                logger.info("Bounds checks: " + to_string(code_gen.get_emitted_bounds_checks()) + " emitted, " +
+                            to_string(code_gen.get_eliminated_bounds_checks()) + " eliminated statically.", true);
+            }
+            code_gen.optimize();
+            timer.phase("optimization");
+
+            if(options.run){
+                timer.report(filename, out);
+                logger.info("Running program...", true);
+                if(code_gen.run(exit_code, logger)){
+                    logger.info("Program exited with code " + to_string(exit_code) + ".", true);
+                }
+            }
+            else{
+                bool emitted;
+                if(objects){
+                    emitted = code_gen.emit(*objects, logger);
+                }else if(options.codegen.codegen_jobs > 0 && options.codegen.output_type == OutputFileType::ObjectFile){
+                    // the partitions are combined into the single object file the user asked for
+                    std::vector<llvm::SmallVector<char, 0>> partitions;
+                    emitted = code_gen.emit(partitions, logger);
+                    if(emitted){
+                        ExecutableLinker combiner(logger);
+                        for(auto &partition : partitions){
+                            combiner.add_object(filename, std::move(partition));
+                        }
+                        emitted = combiner.combine(CodeGenerator::output_file(filename, options.codegen.output_type));
+                    }
+                }else{
+                    emitted = code_gen.emit(logger);
+                }
+                timer.phase("emission");
+
+                if(emitted && !cache_key.empty() && logger.getErrorCount() == 0){
+                    bool stored = false;
+                    std::vector<llvm::SmallVector<char, 0>> outputs;
+                    if(objects){
+                        outputs = *objects;
+                    }else if(auto output = llvm::MemoryBuffer::getFile(CodeGenerator::output_file(filename, options.codegen.output_type))){
+                        outputs.emplace_back((*output)->getBufferStart(), (*output)->getBufferEnd());
+                    }
+                    if(!outputs.empty()){
+                        outputs.emplace_back();
+                        if(!symbol_file.empty()){
+                            if(auto symbols = llvm::MemoryBuffer::getFile(symbol_file)){
+                                outputs.back().append((*symbols)->getBufferStart(), (*symbols)->getBufferEnd());
+                            }
+                        }
+                        stored = options.cache->store(cache_key, outputs);
+                    }
+                    if(!stored){
+                        logger.warning(filename, "Could not store the output in the compilation cache.");
+                    }
+                }
+                timer.report(filename, out);
+                if(emitted){
+                    logger.info("Code generation successful.", true);
+                }else{
+                    logger.info("Errors occurred during code generation.", true);
+                }
+            }
+
+        }
+
+    }else{
+        logger.info("Errors occurred during parsing.", true);
+    }
+
+    report_status(logger);
+}
+
+// Links the objects of the inputs into the executable, whole programs are bitcode that is linked and optimized first
+static bool link_executable(const std::vector<string> &filenames, std::vector<std::vector<llvm::SmallVector<char, 0>>> &objects,
+                            const DriverOptions &options, Logger &logger) {
+    ExecutableLinker linker(logger, options.codegen.profile_generate);
+    if(options.codegen.whole_program){
+        std::vector<std::pair<string, llvm::SmallVector<char, 0>>> bitcode;
+        for(size_t i = 0; i < filenames.size(); i++){
+            for(auto &module : objects[i]){
+                bitcode.emplace_back(filenames[i], std::move(module));
+            }
+        }
+
+        // the linked modules bring their own debug information
+        auto link_options = options.codegen;
+        link_options.output_type = OutputFileType::ObjectFile;
+        link_options.debug_info = false;
+        PhaseTimer timer(options.timing);
+        logger.info("Optimizing the whole program...", true);
+        CodeGenerator program(options.output, link_options);
+        if(!program.link_modules(bitcode, logger)){
+            logger.error(options.output, "Could not link the modules of the program.");
+            return false;
+        }
+        timer.phase("linking modules");
+        program.optimize();
+        timer.phase("optimization");
+        std::vector<llvm::SmallVector<char, 0>> program_objects;
+        if(!program.emit(program_objects, logger)){
+            return false;
+        }
+        timer.phase("emission");
+        timer.report(options.output, cout);
+        for(auto &object : program_objects){
+            linker.add_object(options.output, std::move(object));
+        }
+    }else{
+        for(size_t i = 0; i < filenames.size(); i++){
+            for(auto &object : objects[i]){
+                linker.add_object(filenames[i], std::move(object));
+            }
+        }
+    }
+    return linker.link(options.output);
+}
+
 int main(const int argc, const char *argv[]) {
 
     auto options = init_options();
@@ -25,7 +440,7 @@ int main(const int argc, const char *argv[]) {
 
     if(vm->count("help")){
         cout << "Oberon0 to LLVM-IR Compiler\n";
-        cout << "Usage: oberon0c [options] file\n";
+        cout << "Usage: oberon0c [options] file...\n";
         cout << *options << std::endl;
         return 0;
     }
@@ -35,73 +450,300 @@ int main(const int argc, const char *argv[]) {
         return 1;
     }
 
-    string filename = (*vm)["input"].as<string>();
+    auto filenames = (*vm)["input"].as<std::vector<string>>();
 
-    Logger logger;
+    DriverOptions driver_options{};
     if(vm->count("quiet")){
-        logger.setLevel(LogLevel::QUIET);
+        driver_options.log_level = LogLevel::QUIET;
     } else if(vm->count("debug")){
-        logger.setLevel(LogLevel::DEBUG);
+        driver_options.log_level = LogLevel::DEBUG;
     } else{
-        logger.setLevel(LogLevel::INFO);
+        driver_options.log_level = LogLevel::INFO;
     }
+    driver_options.print = vm->count("print");
+    driver_options.run = vm->count("run");
+    driver_options.timing = vm->count("timing");
 
-    OutputFileType output_type;
-    auto specified_output_type = (vm->count("filetype"))? (*vm)["filetype"].as<string>() : "ll";
+    if(driver_options.run && filenames.size() != 1){
+        cerr << "Running a program requires exactly one input file." << endl;
+        return 1;
+    }
+
+    if(vm->count("output")){
+        driver_options.output = (*vm)["output"].as<string>();
+        if(driver_options.run){
+            cerr << "Running a program and linking an executable cannot be combined." << endl;
+            return 1;
+        }
+    }
+
+    CodeGenOptions &codegen_options = driver_options.codegen;
+    auto specified_output_type = (vm->count("filetype"))? (*vm)["filetype"].as<string>() : (driver_options.output.empty() ? "ll" : "obj");
     if(specified_output_type == "ll"){
-        output_type = OutputFileType::LLVMIRFile;
+        codegen_options.output_type = OutputFileType::LLVMIRFile;
     }else if(specified_output_type == "asm"){
-        output_type = OutputFileType::AssemblyFile;
+        codegen_options.output_type = OutputFileType::AssemblyFile;
     }else if(specified_output_type == "obj"){
-        output_type = OutputFileType::ObjectFile;
+        codegen_options.output_type = OutputFileType::ObjectFile;
+    }else if(specified_output_type == "bc"){
+        codegen_options.output_type = OutputFileType::BitcodeFile;
     }else{
         cerr << "Requested output filetype '" << specified_output_type << "' not supported." << endl;
         return 1;
     }
 
-    // Scanning
-    logger.info("Starting scanning...",true);
-    Scanner scanner(filename, logger);
-    logger.info("Scanning successful. Starting Parsing...",true);
+    if(!driver_options.output.empty()){
+        if(codegen_options.output_type != OutputFileType::ObjectFile){
+            cerr << "Linking an executable requires object output." << endl;
+            return 1;
+        }
+        codegen_options.position_independent = true;
+        codegen_options.runtime = true;
+    }
 
-    // Parsing
-    Parser parser(scanner,logger);
-    auto ast = parser.parse();
-    if(ast && logger.getErrorCount() == 0){
+    // each module is compiled to bitcode, which is only lowered to object code once the modules have been linked
+    if(vm->count("whole-program")){
+        if(driver_options.output.empty()){
+            cerr << "Whole-program optimization requires linking an executable with '-o'." << endl;
+            return 1;
+        }
+        codegen_options.whole_program = true;
+        codegen_options.output_type = OutputFileType::BitcodeFile;
+    }
 
-        if(vm->count("print")){
-            std::cout << "Compiled Program:" << std::endl << *ast << std::endl;
+    auto specified_opt_level = (vm->count("optimize"))? (*vm)["optimize"].as<int>() : 0;
+    switch(specified_opt_level){
+        case 0: codegen_options.opt_level = OptLevel::O0; break;
+        case 1: codegen_options.opt_level = OptLevel::O1; break;
+        case 2: codegen_options.opt_level = OptLevel::O2; break;
+        case 3: codegen_options.opt_level = OptLevel::O3; break;
+        default:
+            cerr << "Requested optimization level '" << specified_opt_level << "' not supported." << endl;
+            return 1;
+    }
+
+    codegen_options.bounds_check = vm->count("bounds-check");
+    codegen_options.debug_info = vm->count("debug-info");
+
+    codegen_options.profile_generate = vm->count("profile-generate");
+    if(vm->count("profile-use")){
+        codegen_options.profile_use = (*vm)["profile-use"].as<string>();
+        if(codegen_options.profile_generate){
+            cerr << "Generating and using a profile cannot be combined." << endl;
+            return 1;
+        }
+        if(codegen_options.opt_level == OptLevel::O0){
+            cerr << "Using a profile requires -O1 or higher." << endl;
+            return 1;
+        }
+        if(!llvm::sys::fs::exists(codegen_options.profile_use)){
+            cerr << "Profile '" << codegen_options.profile_use << "' not found." << endl;
+            return 1;
         }
+    }
+    if(codegen_options.profile_generate && driver_options.run){
+        cerr << "Instrumented programs cannot be run in-process, link them with '-o' instead." << endl;
+        return 1;
+    }
 
-        logger.info("Parsing successful. Starting semantic checking...", true);
+    if(vm->count("target")){
+        codegen_options.target_triple = (*vm)["target"].as<string>();
+    }
+    if(vm->count("mcpu")){
+        codegen_options.cpu = (*vm)["mcpu"].as<string>();
+    }
+    if(vm->count("mattr")){
+        codegen_options.features = (*vm)["mattr"].as<string>();
+    }
+    string target_error;
+    if(!CodeGenerator::check_target(codegen_options, target_error)){
+        cerr << "Requested target not supported: " << target_error << "." << endl;
+        return 1;
+    }
+    if(driver_options.run && !CodeGenerator::is_host_target(codegen_options)){
+        cerr << "Running a program and generating code for another architecture cannot be combined." << endl;
+        return 1;
+    }
 
-        // Semantic Checking
-        SemanticChecker semantics(logger);
-        semantics.validate_program(*ast);
+    if(vm->count("import-path")){
+        driver_options.import_paths = (*vm)["import-path"].as<std::vector<string>>();
+    }
 
-        if(logger.getErrorCount() > 0){
-            logger.info("Errors occurred during semantic checking.", true);
+    if(vm->count("jobs")){
+        codegen_options.codegen_jobs = std::max((*vm)["jobs"].as<unsigned int>(), 1u);
+    }
+
+    std::unique_ptr<CompilationCache> cache;
+    if(vm->count("cache-dir")){
+        auto directory = (*vm)["cache-dir"].as<string>();
+        if(auto ec = llvm::sys::fs::create_directories(directory)){
+            cerr << "Could not create cache directory '" << directory << "': " << ec.message() << endl;
+            return 1;
+        }
+        cache = std::make_unique<CompilationCache>(directory);
+        driver_options.cache = cache.get();
+        driver_options.configuration = cache_configuration(codegen_options);
+    }
+    bool cache_stats = vm->count("cache-stats");
+    auto report_cache = [&]() {
+        if(cache && cache_stats){
+            cout << "Compilation cache: " << cache->hits() << " hit(s), " << cache->misses() << " miss(es)." << endl;
+        }
+    };
+
+    unsigned int threads = (vm->count("threads"))? (*vm)["threads"].as<unsigned int>() : std::thread::hardware_concurrency();
+    threads = std::clamp(threads, 1u, static_cast<unsigned int>(filenames.size()));
+
+    // A single file is compiled on the main thread and reports diagnostics as they occur
+    if(filenames.size() == 1){
+        Logger logger(driver_options.log_level, cout, cerr);
+        int exit_code = 0;
+        auto header = read_header(filenames.front());
+        if(driver_options.output.empty()){
+            compile(filenames.front(), header, driver_options, logger, cout, exit_code);
         }
         else{
+            std::vector<std::vector<llvm::SmallVector<char, 0>>> objects(1);
+            compile(filenames.front(), header, driver_options, logger, cout, exit_code, &objects.front());
+            if(logger.getErrorCount() == 0){
+                link_executable(filenames, objects, driver_options, logger);
+            }
+        }
+        report_cache();
+        exit(logger.getErrorCount() != 0 ? 1 : exit_code);
+    }
 
-            logger.info("Semantic checking successful. Starting code generation...", true);
+    // Inputs importing other inputs need their symbol files, i.e. each input is compiled after the inputs it imports
+    std::vector<ModuleHeader> headers;
+    std::unordered_map<string, size_t> modules;
+    for(size_t i = 0; i < filenames.size(); i++){
+        headers.push_back(read_header(filenames[i]));
+        if(headers[i].name.empty()){
+            continue;
+        }
+        auto [other, inserted] = modules.emplace(headers[i].name, i);
+        if(!inserted){
+            cerr << "Module '" << headers[i].name << "' is defined by both '" << filenames[other->second] << "' and '" << filenames[i] << "'." << endl;
+            return 1;
+        }
+        // the symbol files of all inputs are found regardless of where their importers are
+        auto directory = source_directory(filenames[i]);
+        if(std::find(driver_options.import_paths.begin(), driver_options.import_paths.end(), directory) == driver_options.import_paths.end()){
+            driver_options.import_paths.push_back(directory);
+        }
+    }
 
-            // Code Generation
-            CodeGenerator code_gen(filename,output_type);
-            code_gen.generate_code(*ast);
+    std::vector<std::vector<size_t>> dependents(filenames.size());
+    std::vector<size_t> pending_imports(filenames.size(), 0);
+    for(size_t i = 0; i < filenames.size(); i++){
+        for(auto &import : headers[i].imports){
+            auto module = modules.find(import);
+            if(module != modules.end() && module->second != i){
+                dependents[module->second].push_back(i);
+                pending_imports[i]++;
+            }
+        }
+    }
 
-            logger.info("Code generation successful.", true);
+    std::deque<size_t> ready;
+    for(size_t i = 0; i < filenames.size(); i++){
+        if(pending_imports[i] == 0){
+            ready.push_back(i);
+        }
+    }
 
+    // inputs whose imports never become available import each other
+    {
+        auto unblocked = ready;
+        auto pending = pending_imports;
+        size_t ordered = 0;
+        for(; !unblocked.empty(); ordered++){
+            auto i = unblocked.front();
+            unblocked.pop_front();
+            for(auto dependent : dependents[i]){
+                if(--pending[dependent] == 0){
+                    unblocked.push_back(dependent);
+                }
+            }
+        }
+        if(ordered != filenames.size()){
+            cerr << "The input modules import each other cyclically." << endl;
+            return 1;
         }
+    }
 
-    }else{
-        logger.info("Errors occurred during parsing.", true);
+    // Independent inputs are distributed over a pool of worker threads, each compilation uses its own logger
+    std::vector<CompilationResult> results(filenames.size());
+    std::vector<bool> import_failed(filenames.size(), false);
+    size_t unfinished = filenames.size();
+    std::mutex schedule_mutex;
+    std::condition_variable schedule_changed;
+
+    auto worker = [&]() {
+        std::unique_lock lock(schedule_mutex);
+        while(true){
+            schedule_changed.wait(lock, [&]() { return !ready.empty() || unfinished == 0; });
+            if(ready.empty()){
+                return;
+            }
+            auto i = ready.front();
+            ready.pop_front();
+            bool skip = import_failed[i];
+            lock.unlock();
+
+            auto &result = results[i];
+            Logger logger(driver_options.log_level, result.out, result.err);
+            if(skip){
+                logger.error(filenames[i], "Not compiled, an imported module failed to compile.");
+                report_status(logger);
+            }else{
+                compile(filenames[i], headers[i], driver_options, logger, result.out, result.exit_code,
+                        driver_options.output.empty() ? nullptr : &result.objects);
+            }
+            result.failed = logger.getErrorCount() != 0;
+
+            lock.lock();
+            unfinished--;
+            for(auto dependent : dependents[i]){
+                import_failed[dependent] = import_failed[dependent] || result.failed;
+                if(--pending_imports[dependent] == 0){
+                    ready.push_back(dependent);
+                }
+            }
+            schedule_changed.notify_all();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for(unsigned int i = 0; i < threads; i++){
+        pool.emplace_back(worker);
+    }
+    for(auto &thread : pool){
+        thread.join();
     }
 
-    string status = (logger.getErrorCount() == 0 ? "complete" : "failed");
-    logger.info("Compilation " + status + ": " +
-                to_string(logger.getErrorCount()) + " error(s), " +
-                to_string(logger.getWarningCount()) + " warning(s), " +
-                to_string(logger.getInfoCount()) + " message(s).", true);
-    exit(logger.getErrorCount() != 0);
-}
\ No newline at end of file
+    // Report diagnostics in the order of the input files
+    int failed = 0;
+    for(auto &result : results){
+        cout << result.out.str();
+        cerr << result.err.str();
+        failed += result.failed;
+    }
+
+    if(failed > 0){
+        cerr << failed << " of " << filenames.size() << " file(s) failed to compile." << endl;
+    }
+    else if(!driver_options.output.empty()){
+        Logger logger(driver_options.log_level, cout, cerr);
+        std::vector<std::vector<llvm::SmallVector<char, 0>>> objects;
+        for(auto &result : results){
+            objects.push_back(std::move(result.objects));
+        }
+        if(!link_executable(filenames, objects, driver_options, logger)){
+            report_cache();
+            exit(1);
+        }
+    }
+    report_cache();
+    exit(failed != 0);
+}
@@ -4,13 +4,12 @@
 //
 
 #include "Parser.h"
-#include "../scanner/IdentToken.h"
 #include "../util/panic.h"
 
-std::unique_ptr<const Token> Parser::expect(TokenType expect)
+std::optional<Token> Parser::expect(TokenType expect)
 {
 
-    if (scanner_.peek()->type() == expect)
+    if (scanner_.peek().type() == expect)
     {
         auto token = scanner_.next();
         return token;
@@ -19,7 +18,7 @@ std::unique_ptr<const Token> Parser::expect(TokenType expect)
     std::ostringstream expected;
     std::ostringstream got;
 
-    got << scanner_.peek()->type();
+    got << scanner_.peek().type();
     expected << expect;
 
     std::ostringstream msg;
@@ -32,10 +31,10 @@ std::unique_ptr<const Token> Parser::expect(TokenType expect)
 
     logger_.error("", msg.str());
     this->has_error = true;
-    return nullptr;
+    return std::nullopt;
 }
 
-std::unique_ptr<const Token> Parser::expect_many(std::vector<TokenType> tokens)
+std::optional<Token> Parser::expect_many(std::vector<TokenType> tokens)
 {
 
     auto token = scanner_.next();
@@ -45,7 +44,7 @@ std::unique_ptr<const Token> Parser::expect_many(std::vector<TokenType> tokens)
 
     for (auto exprect : tokens)
     {
-        if (exprect == token->type())
+        if (exprect == token.type())
         {
             return token;
         }
@@ -55,7 +54,7 @@ std::unique_ptr<const Token> Parser::expect_many(std::vector<TokenType> tokens)
 
     std::ostringstream got;
 
-    got << token->type();
+    got << token.type();
 
     std::ostringstream msg;
 
@@ -67,19 +66,19 @@ std::unique_ptr<const Token> Parser::expect_many(std::vector<TokenType> tokens)
 
     logger_.error("", msg.str());
     this->has_error = true;
-    return nullptr;
+    return std::nullopt;
 }
 
 bool Parser::if_next(TokenType expect)
 {
-    return scanner_.peek()->type() == expect;
+    return scanner_.peek().type() == expect;
 }
 
 // ident -> letter (letter | digit)*  (already recognized by the scanner in full)
 std::unique_ptr<IdentNode> Parser::ident()
 {
     logger_.debug("Ident");
-    auto start = scanner_.peek()->start();
+    auto start = scanner_.peek().start();
 
     auto token = this->expect(TokenType::const_ident);
     if (!token)
@@ -87,8 +86,45 @@ std::unique_ptr<IdentNode> Parser::ident()
         return nullptr;
     }
 
-    auto ident_token = dynamic_cast<const IdentToken *>(token.get());
-    return std::make_unique<IdentNode>(start, ident_token->value()); // success
+    return std::make_unique<IdentNode>(start, token->symbol()); // success
+}
+
+// IdentDef -> ident ("*")?   (the mark exports the declared identifier)
+std::unique_ptr<IdentNode> Parser::ident_def()
+{
+    logger_.debug("IdentDef");
+    auto id = ident();
+
+    if (this->if_next(TokenType::op_times))
+    {
+        scanner_.next();
+        if (id)
+        {
+            id->set_exported();
+        }
+    }
+
+    return id;
+}
+
+// Qualident -> (ident ".")? ident   (the qualifier must be an imported module, otherwise "." starts a selector)
+std::unique_ptr<IdentNode> Parser::qualident()
+{
+    logger_.debug("Qualident");
+    auto id = ident();
+
+    if (id && imports_.contains(id->get_symbol()) && this->if_next(TokenType::period))
+    {
+        scanner_.next();
+        auto name = ident();
+        if (!name)
+        {
+            return nullptr;
+        }
+        return std::make_unique<IdentNode>(id->pos(), Symbol(id->get_value() + "." + name->get_value()));
+    }
+
+    return id;
 }
 
 // integer -> digit (digit)*  (already recognized by the scanner in full)
@@ -103,21 +139,7 @@ std::unique_ptr<IntNode> Parser::integer()
         return nullptr;
     }
 
-    long int_value;
-    switch (token->type())
-    {
-    case TokenType::int_literal:
-        int_value = dynamic_cast<const IntLiteralToken *>(token.get())->value();
-        break;
-    case TokenType::short_literal:
-        int_value = dynamic_cast<const ShortLiteralToken *>(token.get())->value();
-        break;
-    case TokenType::long_literal:
-        int_value = dynamic_cast<const LongLiteralToken *>(token.get())->value();
-        break;
-    default:
-        panic("unreachable");
-    }
+    long int_value = token->int_value();
 
     return std::make_unique<IntNode>(token->start(), int_value);
 }
@@ -125,29 +147,29 @@ std::unique_ptr<IntNode> Parser::integer()
 // char (already recognized by the scanner in full)
 std::unique_ptr<CharNode> Parser::character() {
     auto token = scanner_.next();
-    auto char_value = dynamic_cast<const CharLiteralToken*>(token.get())->value();
-    return std::make_unique<CharNode>(token->start(),char_value);
+    auto char_value = token.char_value();
+    return std::make_unique<CharNode>(token.start(),char_value);
 }
 
 // real/float (already recognized by the scanner in full)
 std::unique_ptr<FloatNode> Parser::real() {
     auto token = scanner_.next();
-    double float_value = dynamic_cast<const FloatLiteralToken *>(token.get())->value();
-    return std::make_unique<FloatNode>(token->start(),float_value);
+    double float_value = static_cast<float>(token.real_value());
+    return std::make_unique<FloatNode>(token.start(),float_value);
 }
 
 // string (recognized by scanner in full)
 std::unique_ptr<StringNode> Parser::string() {
     auto token = scanner_.next();
-    auto val = dynamic_cast<const StringLiteralToken*>(token.get())->value();
-    return std::make_unique<StringNode>(token->start(),val);
+    auto val = token.symbol().str();
+    return std::make_unique<StringNode>(token.start(),val);
 }
 
 // selector -> ("." ident | "[" expression "]" )*
 std::unique_ptr<SelectorNode> Parser::selector()
 {
     logger_.debug("Selector");
-    auto start = scanner_.peek()->start();
+    auto start = scanner_.peek().start();
     auto selector = std::make_unique<SelectorNode>(start);
 
     // Return nullptr for empty selectors
@@ -181,16 +203,16 @@ std::unique_ptr<SelectorNode> Parser::selector()
     return selector;
 }
 
-// factor -> ident selector (ActualParameters)? | number | real | "TRUE" | "FALSE" | char | string | "NIL" | "(" expression ")" | "~" factor     // NB: In these types of procedure calls, we do not allow omitting the parentheses
+// factor -> qualident selector (ActualParameters)? | number | real | "TRUE" | "FALSE" | char | string | "NIL" | "(" expression ")" | "~" factor     // NB: In these types of procedure calls, we do not allow omitting the parentheses
 std::unique_ptr<ExpressionNode> Parser::factor()
 {
     logger_.debug("Factor");
-    auto start = scanner_.peek()->start();
+    auto start = scanner_.peek().start();
 
     if (if_next(TokenType::const_ident))
     {
 
-        auto id = ident();
+        auto id = qualident();
         auto sel = selector();
 
         // Now we need to decide whether this refers to an IdentSelectorExpression or to a ProcedureCall
@@ -215,12 +237,12 @@ std::unique_ptr<ExpressionNode> Parser::factor()
     else if (if_next(TokenType::op_not))
     {
         auto factor_token = scanner_.next();
-        return std::make_unique<UnaryExpressionNode>(factor_token->start(), factor(), SourceOperator::NOT);
+        return std::make_unique<UnaryExpressionNode>(factor_token.start(), factor(), SourceOperator::NOT);
     }
     else if(if_next(TokenType::boolean_literal)){
         auto bool_token = scanner_.next();
-        bool bool_value = dynamic_cast<const BooleanLiteralToken *>(bool_token.get())->value();;
-        return std::make_unique<BoolNode>(bool_token->start(),bool_value);
+        bool bool_value = bool_token.bool_value();
+        return std::make_unique<BoolNode>(bool_token.start(),bool_value);
     }
     else if(if_next(TokenType::float_literal)){
         return real();
@@ -246,9 +268,8 @@ std::unique_ptr<ExpressionNode> Parser::term()
 {
     logger_.debug("Term");
 
-    auto start = scanner_.peek()->start();
     auto prev_lhs = factor();
-    auto token_type = scanner_.peek()->type();
+    auto token_type = scanner_.peek().type();
 
     std::unique_ptr<BinaryExpressionNode> full_expr = nullptr;
     BinaryExpressionNode* curr_expr = nullptr;
@@ -267,7 +288,7 @@ std::unique_ptr<ExpressionNode> Parser::term()
         }else {
             curr_expr = curr_expr->insert_rightmost(op,factor());
         }
-        token_type = scanner_.peek()->type();
+        token_type = scanner_.peek().type();
     }
 
     if(!full_expr){
@@ -285,16 +306,15 @@ std::unique_ptr<ExpressionNode> Parser::simple_expression()
 
     logger_.debug("Simple Expression");
 
-    auto start = scanner_.peek()->start();
     auto token = scanner_.peek();
 
     std::unique_ptr<ExpressionNode> first_term = nullptr;
 
-    if (token->type() == TokenType::op_plus || token->type() == TokenType::op_minus)
+    if (token.type() == TokenType::op_plus || token.type() == TokenType::op_minus)
     {
-        if(token->type() == TokenType::op_minus){
+        if(token.type() == TokenType::op_minus){
             scanner_.next();
-            first_term = std::make_unique<UnaryExpressionNode>(token->start(), term(), SourceOperator::NEG);
+            first_term = std::make_unique<UnaryExpressionNode>(token.start(), term(), SourceOperator::NEG);
         }
         else{
             scanner_.next();
@@ -309,10 +329,10 @@ std::unique_ptr<ExpressionNode> Parser::simple_expression()
     BinaryExpressionNode* curr_expr = nullptr;
 
     token = scanner_.peek();
-    while (token->type() == TokenType::op_plus || token->type() == TokenType::op_minus || token->type() == TokenType::op_or)
+    while (token.type() == TokenType::op_plus || token.type() == TokenType::op_minus || token.type() == TokenType::op_or)
     {
 
-        SourceOperator op = ExpressionNode::token_to_op(token->type());
+        SourceOperator op = ExpressionNode::token_to_op(token.type());
         scanner_.next();
 
         if(!full_expr){
@@ -337,10 +357,10 @@ std::unique_ptr<ExpressionNode> Parser::simple_expression()
 std::unique_ptr<ExpressionNode> Parser::expression()
 {
     logger_.debug("Expression");
-    auto start = scanner_.peek()->start();
+    auto start = scanner_.peek().start();
     auto fst_expr = simple_expression();
 
-    auto token_type = scanner_.peek()->type();
+    auto token_type = scanner_.peek().type();
     if (token_type == TokenType::op_eq || token_type == TokenType::op_neq ||
         token_type == TokenType::op_lt || token_type == TokenType::op_leq ||
         token_type == TokenType::op_gt || token_type == TokenType::op_geq)
@@ -358,13 +378,13 @@ std::unique_ptr<ExpressionNode> Parser::expression()
     }
 }
 
-// Assignment -> Ident Selector ":=" Expression
+// Assignment -> Qualident Selector ":=" Expression
 std::unique_ptr<AssignmentNode> Parser::assignment()
 {
     logger_.debug("Assignment");
 
-    auto start = scanner_.peek()->start();
-    auto id = ident();
+    auto start = scanner_.peek().start();
+    auto id = qualident();
     auto sel = selector();
 
     this->expect(TokenType::op_becomes); // Syntax Error (Expected ":=", but got...) (Special Cases: Did you put "=" instead ":=" ? Did you forget the "=" after the ":")
@@ -403,13 +423,13 @@ std::unique_ptr<std::vector<std::unique_ptr<ExpressionNode>>>  Parser::actual_pa
     return actual_params;
 }
 
-// ProcedureCall -> Ident Selector (ActualParameters)?
+// ProcedureCall -> Qualident Selector (ActualParameters)?
 std::unique_ptr<ProcedureCallNode> Parser::procedure_call()
 {
     logger_.debug("Procedure Call");
 
-    auto start = scanner_.peek()->start();
-    auto id = ident();
+    auto start = scanner_.peek().start();
+    auto id = qualident();
     auto sel = selector();
 
     // Check for parenthesis to see whether ActualParameters term exists
@@ -427,7 +447,7 @@ std::unique_ptr<IfStatementNode> Parser::if_statement()
 {
     logger_.debug("If Statement");
 
-    auto start = scanner_.peek()->start();
+    auto start = scanner_.peek().start();
     this->expect(TokenType::kw_if);
     auto condition = expression();
     this->expect(TokenType::kw_then);
@@ -462,7 +482,7 @@ std::unique_ptr<IfStatementNode> Parser::if_statement()
 std::unique_ptr<WhileStatementNode> Parser::while_statement()
 {
     logger_.debug("While Statement");
-    auto start = scanner_.peek()->start();
+    auto start = scanner_.peek().start();
     expect(TokenType::kw_while);
     auto cond = expression();
     expect(TokenType::kw_do);
@@ -475,7 +495,7 @@ std::unique_ptr<WhileStatementNode> Parser::while_statement()
 std::unique_ptr<RepeatStatementNode> Parser::repeat_statement()
 {
     logger_.debug("Repeat Statement");
-    auto start = scanner_.peek()->start();
+    auto start = scanner_.peek().start();
     expect(TokenType::kw_repeat);
     auto statements = statement_sequence();
     expect(TokenType::kw_until);
@@ -487,7 +507,7 @@ std::unique_ptr<RepeatStatementNode> Parser::repeat_statement()
 std::unique_ptr<ReturnStatementNode> Parser::return_statement() {
     logger_.debug("Return Statement");
 
-    auto start = scanner_.peek()->start();
+    auto start = scanner_.peek().start();
     expect(TokenType::kw_return);
 
     // If an "END" or an ";" follows, then the Return statement is empty
@@ -505,7 +525,7 @@ std::unique_ptr<StatementNode> Parser::statement()
 
     logger_.debug("Statement");
 
-    auto start = scanner_.peek()->start();
+    auto start = scanner_.peek().start();
 
     // IfStatement
     if (this->if_next(TokenType::kw_if))
@@ -538,10 +558,10 @@ std::unique_ptr<StatementNode> Parser::statement()
         // Thus Oberon-0 is not "really" an LL(1) language, but for the parser this makes little difference
 
         // Recall:
-        //  assignment -> ident selector ":=" expression
-        //  procedureCall -> ident selector [ActualParameters]?
+        //  assignment -> qualident selector ":=" expression
+        //  procedureCall -> qualident selector [ActualParameters]?
 
-        auto id = ident();
+        auto id = qualident();
         auto sel = selector();
 
         // Assignment
@@ -567,7 +587,7 @@ std::unique_ptr<StatementNode> Parser::statement()
 std::unique_ptr<StatementSequenceNode> Parser::statement_sequence()
 {
     logger_.debug("Statement Sequence");
-    auto start = scanner_.peek()->start();
+    auto start = scanner_.peek().start();
     auto first = statement();
     auto sequence = std::make_unique<StatementSequenceNode>(start, std::move(first));
     while (this->if_next(TokenType::semicolon))
@@ -579,28 +599,26 @@ std::unique_ptr<StatementSequenceNode> Parser::statement_sequence()
     return sequence;
 }
 
-// IdentList -> Ident ("," ident)*
+// IdentList -> IdentDef ("," IdentDef)*
 std::unique_ptr<std::vector<std::unique_ptr<IdentNode>>> Parser::ident_list()
 {
     logger_.debug("Ident List");
-    auto start = scanner_.peek()->start();
     auto id_list = std::make_unique<std::vector<std::unique_ptr<IdentNode>>>();
-    id_list->emplace_back(ident());
+    id_list->emplace_back(ident_def());
 
     while (this->if_next(TokenType::comma))
     {
         scanner_.next();
-        id_list->emplace_back(ident());
+        id_list->emplace_back(ident_def());
     }
 
     return id_list;
 }
 
-// FieldList -> (IdentList ":" type)?
+// FieldList -> (IdentList ":" type)?   (export marks on fields are accepted, all fields of an exported record are visible)
 std::unique_ptr<field> Parser::field_list()
 {
     logger_.debug("Field List");
-    auto start = scanner_.peek()->start();
     // Check Follows(FieldList) to decide whether this FieldList is empty or not
     // Follows(FieldList) = ; END
     if (this->if_next(TokenType::semicolon) || this->if_next(TokenType::kw_end))
@@ -614,7 +632,7 @@ std::unique_ptr<field> Parser::field_list()
     return std::make_unique<field>(std::move(idents), std::move(idents_type));
 }
 
-// Type -> Ident | ArrayType | RecordType | PointerType
+// Type -> Qualident | ArrayType | RecordType | PointerType
 std::unique_ptr<TypeNode> Parser::type()
 {
     logger_.debug("Type");
@@ -638,7 +656,7 @@ std::unique_ptr<TypeNode> Parser::type()
     else
     {
         // Identifier
-        return ident();
+        return qualident();
     }
 }
 
@@ -646,7 +664,7 @@ std::unique_ptr<TypeNode> Parser::type()
 std::unique_ptr<ArrayTypeNode> Parser::array_type()
 {
     logger_.debug("Array Type");
-    auto start = scanner_.peek()->start();
+    auto start = scanner_.peek().start();
     this->expect(TokenType::kw_array);
     auto expr = expression();
     this->expect(TokenType::kw_of);
@@ -658,7 +676,7 @@ std::unique_ptr<ArrayTypeNode> Parser::array_type()
 std::unique_ptr<RecordTypeNode> Parser::record_type()
 {
     logger_.debug("Record Type");
-    auto start = scanner_.peek()->start();
+    auto start = scanner_.peek().start();
     this->expect(TokenType::kw_record);
     auto rec_type = std::make_unique<RecordTypeNode>(start, field_list());
     while (this->if_next(TokenType::semicolon))
@@ -674,7 +692,7 @@ std::unique_ptr<RecordTypeNode> Parser::record_type()
 // PointerType = "POINTER TO" type
 std::unique_ptr<PointerTypeNode> Parser::pointer_type() {
     logger_.debug("Pointer Type");
-    auto start = scanner_.peek()->start();
+    auto start = scanner_.peek().start();
     this->expect(TokenType::kw_pointer);
     this->expect(TokenType::kw_to);
     return std::make_unique<PointerTypeNode>(start,type());
@@ -684,7 +702,6 @@ std::unique_ptr<PointerTypeNode> Parser::pointer_type() {
 std::unique_ptr<fp_section_t> Parser::fp_section()
 {
     logger_.debug("FPSection");
-    auto start = scanner_.peek()->start();
     bool var_included = false;
 
     if (this->if_next(TokenType::kw_var))
@@ -703,7 +720,6 @@ std::unique_ptr<fp_section_t> Parser::fp_section()
 std::unique_ptr<parameters> Parser::formal_parameters()
 {
     logger_.debug("Formal Parameters");
-    auto start = scanner_.peek()->start();
 
 
     auto formal_params = std::make_unique<std::vector<std::unique_ptr<std::tuple<bool,std::unique_ptr<std::vector<std::unique_ptr<IdentNode>>>,std::unique_ptr<TypeNode>>>>>();
@@ -729,13 +745,12 @@ std::unique_ptr<parameters> Parser::formal_parameters()
     return formal_params;
 }
 
-// ProcedureHeadingNode -> "PROCEDURE" Ident (FormalParameters)? (":" Type)?
+// ProcedureHeadingNode -> "PROCEDURE" IdentDef (FormalParameters)? (":" Type)?
 std::tuple<std::unique_ptr<IdentNode>,std::unique_ptr<parameters>,std::unique_ptr<TypeNode>> Parser::procedure_heading()
 {
     logger_.debug("Procedure Heading");
-    auto start = scanner_.peek()->start();
     this->expect(TokenType::kw_procedure);
-    auto id = ident();
+    auto id = ident_def();
 
     std::unique_ptr<parameters> formal_params = nullptr;
     std::unique_ptr<TypeNode>   return_type   = nullptr;
@@ -760,7 +775,6 @@ std::tuple<std::unique_ptr<IdentNode>,std::unique_ptr<parameters>,std::unique_pt
 std::tuple<std::unique_ptr<DeclarationsNode>, std::unique_ptr<IdentNode>, std::unique_ptr<StatementSequenceNode>> Parser::procedure_body()
 {
     logger_.debug("Procedure Body");
-    auto start = scanner_.peek()->start();
     auto declars = declarations();
 
     // Statement Sequence
@@ -778,7 +792,7 @@ std::tuple<std::unique_ptr<DeclarationsNode>, std::unique_ptr<IdentNode>, std::u
 std::unique_ptr<ProcedureDeclarationNode> Parser::procedure_declaration()
 {
     logger_.debug("Procedure Declaration");
-    auto start = scanner_.peek()->start();
+    auto start = scanner_.peek().start();
     auto heading = procedure_heading();
 
     this->expect(TokenType::semicolon);
@@ -786,14 +800,14 @@ std::unique_ptr<ProcedureDeclarationNode> Parser::procedure_declaration()
     return std::make_unique<ProcedureDeclarationNode>(start, std::move(std::get<0>(heading)), std::move(std::get<1>(heading)), std::move(std::get<0>(body)), std::move(std::get<1>(body)), std::move(std::get<2>(body)),std::move(std::get<2>(heading)));
 }
 
-//  Declarations ->    ("CONST" (ident "=" expression ";")* )?
-//                     ("TYPE"  (ident "=" type ";") *      )?
+//  Declarations ->    ("CONST" (IdentDef "=" expression ";")* )?
+//                     ("TYPE"  (IdentDef "=" type ";") *      )?
 //                     ("VAR"   (identList ":" type ";")*   )?
 //                     (ProcedureDeclaration ";"            )*
 std::unique_ptr<DeclarationsNode> Parser::declarations()
 {
     logger_.debug("Declarations");
-    auto start = scanner_.peek()->start();
+    auto start = scanner_.peek().start();
 
     auto declarations_node = std::make_unique<DeclarationsNode>(start);
 
@@ -802,10 +816,10 @@ std::unique_ptr<DeclarationsNode> Parser::declarations()
     {
         scanner_.next();
 
-        // (ident "=" expression ";")*
+        // (IdentDef "=" expression ";")*
         while (this->if_next(TokenType::const_ident))
         {
-            auto id = ident();
+            auto id = ident_def();
             this->expect(TokenType::op_eq);
             auto expr = expression();
             this->expect(TokenType::semicolon);
@@ -818,10 +832,10 @@ std::unique_ptr<DeclarationsNode> Parser::declarations()
     {
         scanner_.next();
 
-        // (ident "=" type ";")*
+        // (IdentDef "=" type ";")*
         while (this->if_next(TokenType::const_ident))
         {
-            auto id = ident();
+            auto id = ident_def();
             this->expect(TokenType::op_eq);
             auto id_type = type();
             this->expect(TokenType::semicolon);
@@ -856,16 +870,47 @@ std::unique_ptr<DeclarationsNode> Parser::declarations()
     return declarations_node;
 }
 
-// Module -> "Module" ident ";" declarations ("BEGIN" StatementSequence)? "END" ident "."
+// ImportList -> "IMPORT" ident ("," ident)* ";"
+std::vector<std::unique_ptr<IdentNode>> Parser::import_list()
+{
+    logger_.debug("Import List");
+    std::vector<std::unique_ptr<IdentNode>> modules;
+
+    this->expect(TokenType::kw_import);
+    modules.emplace_back(ident());
+    while (this->if_next(TokenType::comma))
+    {
+        scanner_.next();
+        modules.emplace_back(ident());
+    }
+    this->expect(TokenType::semicolon);
+
+    for (auto &module : modules)
+    {
+        if (module)
+        {
+            imports_.insert(module->get_symbol());
+        }
+    }
+    return modules;
+}
+
+// Module -> "Module" ident ";" (ImportList)? declarations ("BEGIN" StatementSequence)? "END" ident "."
 std::unique_ptr<ModuleNode> Parser::module()
 {
     logger_.debug("Module");
-    auto start = scanner_.peek()->start();
+    auto start = scanner_.peek().start();
 
     this->expect(TokenType::kw_module);
     auto module_name_begin = ident();
     this->expect(TokenType::semicolon);
 
+    std::vector<std::unique_ptr<IdentNode>> imports;
+    if (this->if_next(TokenType::kw_import))
+    {
+        imports = import_list();
+    }
+
     auto declars = declarations();
 
     // Statement Sequence
@@ -886,7 +931,15 @@ std::unique_ptr<ModuleNode> Parser::module()
         this->has_error = true;
     }
 
-    return std::make_unique<ModuleNode>(start, std::move(module_name_begin), std::move(declars), std::move(statements), std::move(module_name_end));
+    auto module = std::make_unique<ModuleNode>(start, std::move(module_name_begin), std::move(declars), std::move(statements), std::move(module_name_end));
+    for (auto &import : imports)
+    {
+        if (import)
+        {
+            module->add_import(std::move(import));
+        }
+    }
+    return module;
 }
 
 std::unique_ptr<ModuleNode> Parser::parse()
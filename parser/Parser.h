@@ -7,7 +7,9 @@
 #ifndef OBERON0C_PARSER_H
 #define OBERON0C_PARSER_H
 
+#include <optional>
 #include <string>
+#include <unordered_set>
 #include "scanner/Scanner.h"
 #include "util/datastructures/ast/Node.h"
 
@@ -44,12 +46,16 @@ private:
     Scanner &scanner_;
     Logger &logger_;
     bool has_error;
+    // names of the imported modules, "M.x" is parsed as a single (qualified) identifier if M is one of them
+    std::unordered_set<Symbol> imports_;
 
-    std::unique_ptr<const Token> expect(TokenType);
-    std::unique_ptr<const Token> expect_many(std::vector<TokenType>);
+    std::optional<Token> expect(TokenType);
+    std::optional<Token> expect_many(std::vector<TokenType>);
     bool if_next(TokenType);
 
     std::unique_ptr<IdentNode> ident();
+    std::unique_ptr<IdentNode> ident_def();
+    std::unique_ptr<IdentNode> qualident();
     std::unique_ptr<IntNode> integer();
     std::unique_ptr<FloatNode> real();
     std::unique_ptr<CharNode> character();
@@ -87,6 +93,7 @@ private:
     std::tuple<std::unique_ptr<DeclarationsNode>, std::unique_ptr<IdentNode>, std::unique_ptr<StatementSequenceNode>> procedure_body();
     std::unique_ptr<ProcedureDeclarationNode> procedure_declaration();
     std::unique_ptr<DeclarationsNode> declarations();
+    std::vector<std::unique_ptr<IdentNode>> import_list();
 
     std::unique_ptr<ModuleNode> module();
 
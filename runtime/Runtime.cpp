@@ -0,0 +1,28 @@
+//
+// Created by M on 17.10.2026.
+//
+
+#include "Runtime.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+// The runtime is linked by a C compiler driver, so it must not depend on the C++ standard library
+
+static const char *trap_message(int64_t code)
+{
+    switch (code)
+    {
+    case TRAP_INDEX_OUT_OF_BOUNDS:
+        return "array index out of bounds";
+    default:
+        return "trap";
+    }
+}
+
+void oberon_trap(int64_t code)
+{
+    std::fprintf(stderr, "Oberon runtime error: %s (trap %lld)\n", trap_message(code), static_cast<long long>(code));
+    std::fflush(stderr);
+    std::exit(static_cast<int>(code));
+}
@@ -0,0 +1,25 @@
+//
+// Created by M on 17.10.2026.
+//
+
+#ifndef OBERON0C_RUNTIME_H
+#define OBERON0C_RUNTIME_H
+
+#include <cstdint>
+
+// Kinds of runtime errors, a program terminated by a trap exits with the trap's code
+enum TrapCode : int64_t
+{
+    TRAP_INDEX_OUT_OF_BOUNDS = 1
+};
+
+// Support routines linked into every executable produced with '-o'.
+// They are called from generated code and therefore use C linkage.
+extern "C" {
+
+    // Reports a runtime error of the given kind and terminates the program
+    [[noreturn]] void oberon_trap(int64_t code);
+
+}
+
+#endif //OBERON0C_RUNTIME_H
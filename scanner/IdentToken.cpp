@@ -1,15 +0,0 @@
-/*
- * Ident token returned by scanner of the Oberon-0 compiler.
- *
- * Created by Michael Grossniklaus on 2/27/18.
- */
-
-#include "IdentToken.h"
-
-std::string IdentToken::value() const {
-    return value_;
-}
-
-void IdentToken::print(std::ostream &stream) const {
-    stream << this->type() << ": " << value_;
-}
\ No newline at end of file
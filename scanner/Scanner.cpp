@@ -5,8 +5,10 @@
  */
 
 
+#include <array>
 #include <cctype>
 #include <memory>
+#include <string_view>
 
 #include <boost/algorithm/string/replace.hpp>
 #include <boost/convert.hpp>
@@ -15,85 +17,145 @@
 
 #include <config.h>
 #include "Scanner.h"
-#include "IdentToken.h"
-#include "LiteralToken.h"
-#include "UndefinedToken.h"
+#include "util/SourceManager.h"
+#include "util/panic.h"
 
-using std::make_unique;
+using std::string_view;
+
+namespace {
+
+    struct Keyword {
+        string_view name;
+        TokenType type;
+    };
+
+    constexpr Keyword keywords[] = {
+            { "DIV", TokenType::op_div }, { "MOD", TokenType::op_mod },
+            { "OR", TokenType::op_or }, { "IN", TokenType::op_in }, { "IS", TokenType::op_is },
+            { "MODULE", TokenType::kw_module }, { "IMPORT", TokenType::kw_import },
+            { "PROCEDURE", TokenType::kw_procedure }, { "EXTERN", TokenType::kw_extern },
+            { "BEGIN", TokenType::kw_begin }, { "END", TokenType::kw_end },
+            { "RETURN", TokenType::kw_return },
+            { "LOOP", TokenType::kw_loop }, { "EXIT", TokenType::kw_exit },
+            { "WHILE", TokenType::kw_while }, { "DO", TokenType::kw_do },
+            { "REPEAT", TokenType::kw_repeat }, { "UNTIL", TokenType::kw_until },
+            { "FOR", TokenType::kw_for }, { "TO", TokenType::kw_to },
+            { "BY", TokenType::kw_by },
+            { "IF", TokenType::kw_if }, { "THEN", TokenType::kw_then },
+            { "ELSE", TokenType::kw_else }, { "ELSIF", TokenType::kw_elsif },
+            { "CASE", TokenType::kw_case },
+            { "VAR", TokenType::kw_var }, { "CONST", TokenType::kw_const },
+            { "TYPE", TokenType::kw_type }, { "ARRAY", TokenType::kw_array },
+            { "RECORD", TokenType::kw_record }, { "OF", TokenType::kw_of },
+            { "POINTER", TokenType::kw_pointer }, { "NIL", TokenType::kw_nil },
+            { "TRUE", TokenType::boolean_literal}, { "FALSE", TokenType::boolean_literal } };
+
+    constexpr size_t keyword_count = sizeof(keywords) / sizeof(keywords[0]);
+    constexpr size_t keyword_min_length = 2;
+    constexpr size_t keyword_max_length = 9;
+    constexpr size_t keyword_table_size = 64;
+
+    // Perfect hash over the keywords: only the first two characters, the last character and the length are inspected.
+    // The coefficients were chosen such that no two keywords share a slot (checked by the static_assert below).
+    constexpr size_t keyword_hash(string_view str) {
+        return (static_cast<size_t>(str[0]) * 2 + static_cast<size_t>(str[1]) * 12 +
+                static_cast<size_t>(str[str.size() - 1]) * 38 + str.size()) % keyword_table_size;
+    }
+
+    // Maps each hash slot to the index of its keyword, or -1 if the slot is empty
+    constexpr std::array<int, keyword_table_size> build_keyword_table() {
+        std::array<int, keyword_table_size> table{};
+        for (auto &slot : table) {
+            slot = -1;
+        }
+        for (size_t i = 0; i < keyword_count; i++) {
+            table[keyword_hash(keywords[i].name)] = static_cast<int>(i);
+        }
+        return table;
+    }
+
+    constexpr auto keyword_table = build_keyword_table();
+
+    constexpr bool keyword_table_complete() {
+        for (size_t i = 0; i < keyword_count; i++) {
+            if (keywords[i].name.size() < keyword_min_length || keywords[i].name.size() > keyword_max_length ||
+                keyword_table[keyword_hash(keywords[i].name)] != static_cast<int>(i)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static_assert(keyword_table_complete(), "keyword hash has collisions, choose different coefficients");
+
+    const Keyword* lookup_keyword(string_view str) {
+        if (str.size() < keyword_min_length || str.size() > keyword_max_length) {
+            return nullptr;
+        }
+        auto index = keyword_table[keyword_hash(str)];
+        if (index < 0 || keywords[index].name != str) {
+            return nullptr;
+        }
+        return &keywords[index];
+    }
+
+}
 
 Scanner::Scanner(const path &path, Logger &logger) : logger_(logger), path_(path),
-        tokens_(), lineNo_(1), charNo_(0), ch_{}, eof_(false) {
-    init();
-    file_.open(path_.string(), std::ifstream::binary);
-    if (!file_.is_open()) {
-        logger_.error(PROJECT_NAME, "cannot open file: " + path_.string() + ".");
-        exit(1);
+        file_(SourceManager::load_file(path.string(), logger)), lookahead_(), head_(0), count_(0),
+        ch_{}, eof_(false), begin_(nullptr), cur_(nullptr), end_(nullptr) {
+    if (!file_) {
+        // scanning a file that cannot be loaded yields <eof> right away
+        eof_ = true;
+        return;
     }
+    auto &buffer = SourceManager::buffer(file_);
+    begin_ = buffer.getBufferStart();
+    cur_ = begin_;
+    end_ = buffer.getBufferEnd();
     read();
 }
 
-Scanner::~Scanner() {
-    if (file_.is_open()) {
-        file_.close();
-    }
+Scanner::Scanner(const path &path, const llvm::MemoryBuffer &buffer, Logger &logger) : logger_(logger), path_(path),
+        file_(0), lookahead_(), head_(0), count_(0), ch_{}, eof_(false), begin_(buffer.getBufferStart()),
+        cur_(begin_), end_(buffer.getBufferEnd()) {
+    read();
 }
 
-void Scanner::init() {
-    keywords_ = { { "DIV", TokenType::op_div }, { "MOD", TokenType::op_mod },
-                  { "OR", TokenType::op_or }, { "IN", TokenType::op_in }, { "IS", TokenType::op_is },
-                  { "MODULE", TokenType::kw_module }, { "IMPORT", TokenType::kw_import },
-                  { "PROCEDURE", TokenType::kw_procedure }, { "EXTERN", TokenType::kw_extern },
-                  { "BEGIN", TokenType::kw_begin }, { "END", TokenType::kw_end },
-                  { "RETURN", TokenType::kw_return },
-                  { "LOOP", TokenType::kw_loop }, { "EXIT", TokenType::kw_exit },
-                  { "WHILE", TokenType::kw_while }, { "DO", TokenType::kw_do },
-                  { "REPEAT", TokenType::kw_repeat }, { "UNTIL", TokenType::kw_until },
-                  { "FOR", TokenType::kw_for }, { "TO", TokenType::kw_to },
-                  { "BY", TokenType::kw_by },
-                  { "IF", TokenType::kw_if }, { "THEN", TokenType::kw_then },
-                  { "ELSE", TokenType::kw_else }, { "ELSIF", TokenType::kw_elsif },
-                  { "CASE", TokenType::kw_case },
-                  { "VAR", TokenType::kw_var }, { "CONST", TokenType::kw_const },
-                  { "TYPE", TokenType::kw_type }, { "ARRAY", TokenType::kw_array },
-                  { "RECORD", TokenType::kw_record }, { "OF", TokenType::kw_of },
-                  { "POINTER", TokenType::kw_pointer }, { "NIL", TokenType::kw_nil },
-                  { "TRUE", TokenType::boolean_literal}, { "FALSE", TokenType::boolean_literal } };
+Scanner::~Scanner() {
+    SourceManager::release(file_);
 }
 
-const Token* Scanner::peek(bool advance) {
-    if (tokens_.empty()) {
-        tokens_.push(scanToken());
-        return tokens_.back().get();
-    }
-    if (advance) {
-        auto token = tokens_.back().get();
-        tokens_.push(scanToken());
-        return token;
-    } else {
-        return tokens_.front().get();
+const Token &Scanner::peek(size_t ahead) {
+    while (count_ <= ahead) {
+        if (count_ == lookahead_size_) {
+            panic("Scanner lookahead exceeded.");
+        }
+        lookahead_[(head_ + count_) % lookahead_size_] = scanToken();
+        count_++;
     }
+    return lookahead_[(head_ + ahead) % lookahead_size_];
 }
 
-std::unique_ptr<const Token> Scanner::next() {
-    if (tokens_.empty()) {
+Token Scanner::next() {
+    if (count_ == 0) {
         return scanToken();
-    } else {
-        auto token = std::move(tokens_.front());
-        tokens_.pop();
-        return token;
     }
+    auto token = lookahead_[head_];
+    head_ = (head_ + 1) % lookahead_size_;
+    count_--;
+    return token;
 }
 
 void Scanner::seek(const FilePos &pos) {
-    file_.seekg(pos.offset - (streampos)1);
-    queue<unique_ptr<const Token>> empty;
-    std::swap(tokens_, empty);
-    lineNo_ = pos.lineNo;
-    charNo_ = pos.charNo - 1;
+    cur_ = begin_ + SourceManager::index_of(pos);
+    eof_ = false;
+    head_ = 0;
+    count_ = 0;
     ch_ = '\0';
 }
 
-unique_ptr<const Token> Scanner::scanToken() {
+Token Scanner::scanToken() {
     // skip whitespace
     while (!eof_ && ch_ <= ' ') {
         read();
@@ -110,95 +172,94 @@ unique_ptr<const Token> Scanner::scanToken() {
             switch (ch_) {
                 case '&':
                     read();
-                    return make_unique<Token>(TokenType::op_and, pos);
+                    return Token(TokenType::op_and, pos);
                 case '*':
                     read();
-                    return make_unique<Token>(TokenType::op_times, pos);
+                    return Token(TokenType::op_times, pos);
                 case '/':
                     read();
-                    return make_unique<Token>(TokenType::op_divide, pos);
+                    return Token(TokenType::op_divide, pos);
                 case '+':
                     read();
-                    return make_unique<Token>(TokenType::op_plus, pos);
+                    return Token(TokenType::op_plus, pos);
                 case '-':
                     read();
-                    return make_unique<Token>(TokenType::op_minus, pos);
+                    return Token(TokenType::op_minus, pos);
                 case '=':
                     read();
-                    return make_unique<Token>(TokenType::op_eq, pos);
+                    return Token(TokenType::op_eq, pos);
                 case '#':
                     read();
-                    return make_unique<Token>(TokenType::op_neq, pos);
+                    return Token(TokenType::op_neq, pos);
                 case '<':
                     read();
                     if (ch_ == '=') {
                         read();
-                        return make_unique<Token>(TokenType::op_leq, pos, current());
+                        return Token(TokenType::op_leq, pos, current());
                     }
-                    return make_unique<Token>(TokenType::op_lt, pos);
+                    return Token(TokenType::op_lt, pos);
                 case '>':
                     read();
                     if (ch_ == '=') {
                         read();
-                        return make_unique<Token>(TokenType::op_geq, pos, current());
+                        return Token(TokenType::op_geq, pos, current());
                     }
-                    return make_unique<Token>(TokenType::op_gt, pos);
+                    return Token(TokenType::op_gt, pos);
                 case ';':
                     read();
-                    return make_unique<Token>(TokenType::semicolon, pos);
+                    return Token(TokenType::semicolon, pos);
                 case ',':
                     read();
-                    return make_unique<Token>(TokenType::comma, pos);
+                    return Token(TokenType::comma, pos);
                 case ':':
                     read();
                     if (ch_ == '=') {
                         read();
-                        return make_unique<Token>(TokenType::op_becomes, pos, current());
+                        return Token(TokenType::op_becomes, pos, current());
                     }
-                    return make_unique<Token>(TokenType::colon, pos);
+                    return Token(TokenType::colon, pos);
                 case '.':
                     read();
                     if (!eof_ && ch_ == '.') {
-                        FilePos nextPos = current();
                         read();
                         if (!eof_ && ch_ == '.') {
                             read();
-                            return make_unique<Token>(TokenType::varargs, pos, current());
+                            return Token(TokenType::varargs, pos, current());
                         }
-                        return make_unique<Token>(TokenType::range, pos, current());
+                        return Token(TokenType::range, pos, current());
                     }
-                    return make_unique<Token>(TokenType::period, pos, current());
+                    return Token(TokenType::period, pos, current());
                 case '(':
                     read();
                     if (ch_ == '*') {
                         scanComment();
                         return scanToken();
                     }
-                    return make_unique<Token>(TokenType::lparen, pos);
+                    return Token(TokenType::lparen, pos);
                 case ')':
                     read();
-                    return make_unique<Token>(TokenType::rparen, pos);
+                    return Token(TokenType::rparen, pos);
                 case '[':
                     read();
-                    return make_unique<Token>(TokenType::lbrack, pos);
+                    return Token(TokenType::lbrack, pos);
                 case ']':
                     read();
-                    return make_unique<Token>(TokenType::rbrack, pos);
+                    return Token(TokenType::rbrack, pos);
                 case '{':
                     read();
-                    return make_unique<Token>(TokenType::lbrace, pos);
+                    return Token(TokenType::lbrace, pos);
                 case '}':
                     read();
-                    return make_unique<Token>(TokenType::rbrace, pos);
+                    return Token(TokenType::rbrace, pos);
                 case '^':
                     read();
-                    return make_unique<Token>(TokenType::caret, pos);
+                    return Token(TokenType::caret, pos);
                 case '|':
                     read();
-                    return make_unique<Token>(TokenType::pipe, pos);
+                    return Token(TokenType::pipe, pos);
                 case '~':
                     read();
-                    return make_unique<Token>(TokenType::op_not, pos);
+                    return Token(TokenType::op_not, pos);
                 default:
                     read();
                     logger_.error(pos, "bad character.");
@@ -206,34 +267,25 @@ unique_ptr<const Token> Scanner::scanToken() {
             }
         }
     } else {
-        return make_unique<Token>(TokenType::eof, current());
+        return Token(TokenType::eof, current());
     }
 }
 
 void Scanner::read() {
-    if (ch_ == '\n') {
-        lineNo_++;
-        charNo_ = 0;
-    }
-    if (file_.get(ch_)) {
-        charNo_++;
-    } else if (file_.eof()) {
-        charNo_++;
-        eof_ = true;
+    if (cur_ < end_) {
+        ch_ = *cur_++;
     } else {
-        logger_.error(path_.string(), "error reading file.");
-        exit(1);
+        eof_ = true;
     }
-
 }
 
+// Position of the current character (or of the end of the file)
 FilePos Scanner::current() {
-    FilePos pos;
-    pos.fileName = path_.string();
-    pos.lineNo = lineNo_;
-    pos.charNo = charNo_;
-    pos.offset = file_.tellg();
-    return pos;
+    if (!file_) {
+        return {};
+    }
+    auto index = static_cast<uint32_t>(cur_ - begin_) - (eof_ ? 0 : 1);
+    return SourceManager::position(file_, index);
 }
 
 void Scanner::scanComment() {
@@ -267,25 +319,25 @@ void Scanner::scanComment() {
     }
 }
 
-unique_ptr<const Token> Scanner::scanIdent() {
+Token Scanner::scanIdent() {
     FilePos pos = current();
-    std::stringstream ss;
+    // identifiers are sliced directly out of the buffer
+    const char *start = cur_ - 1;
     do {
-        ss << ch_;
         read();
     } while (!eof_ && (std::isalnum(ch_) || ch_ == '_'));
-    std::string ident = ss.str();
-    auto it = keywords_.find(ident);
-    if (it != keywords_.end()) {
-        if (it->second == TokenType::boolean_literal) {
-            return make_unique<BooleanLiteralToken>(pos, current(), it->first == "TRUE");
+    string_view ident(start, static_cast<size_t>((eof_ ? end_ : cur_ - 1) - start));
+    auto keyword = lookup_keyword(ident);
+    if (keyword) {
+        if (keyword->type == TokenType::boolean_literal) {
+            return Token::make_boolean(pos, current(), keyword->name == "TRUE");
         }
-        return make_unique<Token>(it->second, pos, current());
+        return Token(keyword->type, pos, current());
     }
-    return make_unique<IdentToken>(pos, current(), ident);
+    return Token::make_symbol(TokenType::const_ident, pos, current(), Symbol(ident));
 }
 
-unique_ptr<const Token> Scanner::scanNumber() {
+Token Scanner::scanNumber() {
     bool isHex = false;
     bool isFloat = false;
     bool isChar = false;
@@ -307,7 +359,7 @@ unique_ptr<const Token> Scanner::scanNumber() {
     if (ch_ == 'H' || ch_ == 'X') {
         if (isFloat) {
             logger_.error(pos, "undefined number.");
-            auto token = make_unique<UndefinedToken>(pos, ch_);
+            auto token = Token::make_char(TokenType::undef, pos, pos, static_cast<uint8_t>(ch_));
             read();
             return token;
         }
@@ -328,17 +380,17 @@ unique_ptr<const Token> Scanner::scanNumber() {
                 if (result.value() == 0) {
                     value = boost::convert<double>(num, ccnv(std::dec)(std::scientific)).value();
                     if (value != 0) {
-                        return make_unique<DoubleLiteralToken>(pos, current(), value);
+                        return Token::make_real(TokenType::double_literal, pos, current(), value);
                     }
                 }
-                return make_unique<FloatLiteralToken>(pos, current(), result.value());
+                return Token::make_real(TokenType::float_literal, pos, current(), result.value());
             }
             value = boost::convert<double>(num, ccnv(std::dec)(std::scientific)).value();
         } catch (boost::bad_optional_access const &) {
             logger_.error(pos, "invalid floating-point literal: " + num + ".");
             value = 0;
         }
-        return make_unique<DoubleLiteralToken>(pos, current(), value);
+        return Token::make_real(TokenType::double_literal, pos, current(), value);
     } else if (isChar) {
         uint8_t value;
         auto result = boost::convert<uint32_t>(num, ccnv(std::hex));
@@ -348,7 +400,7 @@ unique_ptr<const Token> Scanner::scanNumber() {
             logger_.error(pos, "invalid character literal: " + num + ".");
             value = 0;
         }
-        return make_unique<CharLiteralToken>(pos, current(), value);
+        return Token::make_char(TokenType::char_literal, pos, current(), value);
     } else {
         bool isLong = true;
         bool isInt = true;
@@ -372,16 +424,16 @@ unique_ptr<const Token> Scanner::scanNumber() {
             value = 0;
         }
         if (isLong) {
-            return make_unique<LongLiteralToken>(pos, current(), value);
+            return Token::make_integer(TokenType::long_literal, pos, current(), value);
         } else if (isInt) {
-            return make_unique<IntLiteralToken>(pos, current(), static_cast<int32_t>(value));
+            return Token::make_integer(TokenType::int_literal, pos, current(), static_cast<int32_t>(value));
         } else {
-            return make_unique<ShortLiteralToken>(pos, current(), static_cast<int16_t>(value));
+            return Token::make_integer(TokenType::short_literal, pos, current(), static_cast<int16_t>(value));
         }
     }
 }
 
-unique_ptr<const Token> Scanner::scanString() {
+Token Scanner::scanString() {
     std::stringstream ss;
     auto p = current();
     read();
@@ -397,9 +449,9 @@ unique_ptr<const Token> Scanner::scanString() {
     std::string str = unescape(ss.str());
     if (str.length() <= 1) {
         unsigned char value = str.empty() ? '\0' : static_cast<unsigned char>(str[0]);
-        return make_unique<CharLiteralToken>(p, current(), value);
+        return Token::make_char(TokenType::char_literal, p, current(), value);
     }
-    return make_unique<StringLiteralToken>(p, current(), str);
+    return Token::make_symbol(TokenType::string_literal, p, current(), Symbol(str));
 }
 
 std::string Scanner::escape(std::string str) {
@@ -8,52 +8,53 @@
 #define OBERON0C_SCANNER_H
 
 
+#include <array>
 #include <filesystem>
-#include <fstream>
 #include <sstream>
 #include <memory>
-#include <queue>
 #include <string>
-#include <unordered_map>
+
+#include <llvm/Support/MemoryBuffer.h>
 
 #include "Token.h"
-#include "LiteralToken.h"
 #include "util/Logger.h"
 
 using std::filesystem::path;
-using std::ifstream;
-using std::queue;
-using std::streampos;
 using std::string;
 using std::unique_ptr;
-using std::unordered_map;
 
 class Scanner {
 
 private:
     Logger &logger_;
     const path &path_;
-    queue<unique_ptr<const Token>> tokens_;
-    int lineNo_, charNo_;
+    FileId file_;
+    // lookahead tokens are kept in a small ring buffer, i.e. scanning does not allocate
+    static constexpr size_t lookahead_size_ = 8;
+    std::array<Token, lookahead_size_> lookahead_;
+    size_t head_, count_;
     char ch_;
     bool eof_;
-    unordered_map<string, TokenType> keywords_;
-    ifstream file_;
+    // the whole source file is kept in memory by the SourceManager and scanned as a character range
+    const char *begin_, *cur_, *end_;
 
-    void init();
     void read();
     FilePos current();
-    unique_ptr<const Token> scanToken();
-    unique_ptr<const Token> scanIdent();
-    unique_ptr<const Token> scanNumber();
-    unique_ptr<const Token> scanString();
+    Token scanToken();
+    Token scanIdent();
+    Token scanNumber();
+    Token scanString();
     void scanComment();
 
 public:
     Scanner(const path &path, Logger &logger);
+    // scans a buffer that is not registered with the SourceManager, i.e. the tokens carry no positions
+    Scanner(const path &path, const llvm::MemoryBuffer &buffer, Logger &logger);
+    Scanner(const Scanner &) = delete;
     ~Scanner();
-    const Token* peek(bool = false);
-    unique_ptr<const Token> next();
+    // returns the token 'ahead' positions after the next one without consuming it
+    const Token &peek(size_t ahead = 0);
+    Token next();
     void seek(const FilePos &);
 
     static string escape(string str);
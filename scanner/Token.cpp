@@ -6,7 +6,35 @@
 
 #include "Token.h"
 
-Token::~Token() = default;
+Token Token::make_integer(TokenType type, const FilePos &start, const FilePos &end, int64_t value) {
+    Token token(type, start, end);
+    token.integer_ = value;
+    return token;
+}
+
+Token Token::make_real(TokenType type, const FilePos &start, const FilePos &end, double value) {
+    Token token(type, start, end);
+    token.real_ = value;
+    return token;
+}
+
+Token Token::make_boolean(const FilePos &start, const FilePos &end, bool value) {
+    Token token(TokenType::boolean_literal, start, end);
+    token.boolean_ = value;
+    return token;
+}
+
+Token Token::make_char(TokenType type, const FilePos &start, const FilePos &end, uint8_t value) {
+    Token token(type, start, end);
+    token.character_ = value;
+    return token;
+}
+
+Token Token::make_symbol(TokenType type, const FilePos &start, const FilePos &end, Symbol value) {
+    Token token(type, start, end);
+    token.symbol_ = value;
+    return token;
+}
 
 TokenType Token::type() const {
     return type_;
@@ -20,8 +48,52 @@ FilePos Token::end() const {
     return end_;
 }
 
+int64_t Token::int_value() const {
+    return integer_;
+}
+
+double Token::real_value() const {
+    return real_;
+}
+
+bool Token::bool_value() const {
+    return boolean_;
+}
+
+uint8_t Token::char_value() const {
+    return character_;
+}
+
+Symbol Token::symbol() const {
+    return symbol_;
+}
+
 void Token::print(std::ostream &stream) const {
     stream << type_;
+    switch (type_) {
+        case TokenType::short_literal:
+        case TokenType::int_literal:
+        case TokenType::long_literal:
+            stream << ": " << integer_;
+            break;
+        case TokenType::float_literal:
+        case TokenType::double_literal:
+            stream << ": " << real_;
+            break;
+        case TokenType::boolean_literal:
+            stream << ": " << (boolean_ ? "TRUE" : "FALSE");
+            break;
+        case TokenType::char_literal:
+        case TokenType::undef:
+            stream << ": " << character_;
+            break;
+        case TokenType::const_ident:
+        case TokenType::string_literal:
+            stream << ": " << symbol_;
+            break;
+        default:
+            break;
+    }
 }
 
 std::ostream& operator<<(std::ostream &stream, const Token &token) {
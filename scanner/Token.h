@@ -9,7 +9,10 @@
 
 
 #include "global.h"
+#include "util/Symbol.h"
+#include <cstdint>
 #include <ostream>
+#include <type_traits>
 
 enum class TokenType : char {
     eof, undef,
@@ -32,27 +35,52 @@ enum class TokenType : char {
 
 std::ostream& operator<<(std::ostream &stream, const TokenType &type);
 
+/*
+ * Tokens are small, trivially copyable values: besides their type and span they carry the literal value (or the
+ * interned name of identifiers and strings) in a payload whose active member is determined by the token type.
+ */
 class Token {
 
 private:
     TokenType type_;
     FilePos start_, end_;
+    union {
+        int64_t integer_ = 0;   // short_literal, int_literal, long_literal
+        double real_;           // float_literal, double_literal
+        bool boolean_;          // boolean_literal
+        uint8_t character_;     // char_literal, undef
+        Symbol symbol_;         // const_ident, string_literal
+    };
 
 public:
+    Token() : Token(TokenType::eof, {}, {}) { };
     explicit Token(const TokenType type, const FilePos &start) :
-            Token(type, start, { start.fileName, start.lineNo, start.charNo + 1, start.offset }) { };
+            Token(type, start, { start.offset + 1 }) { };
     explicit Token(const TokenType type, const FilePos &start, const FilePos &end) :
             type_(type), start_(start), end_(end) { };
-    virtual ~Token();
+
+    static Token make_integer(TokenType type, const FilePos &start, const FilePos &end, int64_t value);
+    static Token make_real(TokenType type, const FilePos &start, const FilePos &end, double value);
+    static Token make_boolean(const FilePos &start, const FilePos &end, bool value);
+    static Token make_char(TokenType type, const FilePos &start, const FilePos &end, uint8_t value);
+    static Token make_symbol(TokenType type, const FilePos &start, const FilePos &end, Symbol value);
 
     [[nodiscard]] TokenType type() const;
     [[nodiscard]] FilePos start() const;
     [[nodiscard]] FilePos end() const;
 
-    virtual void print(std::ostream &stream) const;
+    [[nodiscard]] int64_t int_value() const;
+    [[nodiscard]] double real_value() const;
+    [[nodiscard]] bool bool_value() const;
+    [[nodiscard]] uint8_t char_value() const;
+    [[nodiscard]] Symbol symbol() const;
+
+    void print(std::ostream &stream) const;
     friend std::ostream& operator<<(std::ostream &stream, const Token &symbol);
 
 };
 
+static_assert(std::is_trivially_copyable_v<Token>, "tokens are passed around by value");
+
 
 #endif //OBERON0C_TOKEN_H
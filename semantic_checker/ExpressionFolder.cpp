@@ -0,0 +1,513 @@
+//
+// Created by M on 17.10.2026.
+//
+
+#include "ExpressionFolder.h"
+
+#include <climits>
+
+#include "util/datastructures/ast/base_blocks/LiteralNodes.h"
+#include "util/datastructures/ast/statements/AssignmentNode.h"
+#include "util/datastructures/ast/statements/IfStatementNode.h"
+#include "util/datastructures/ast/statements/ProcedureCallNode.h"
+#include "util/datastructures/ast/statements/RepeatStatementNode.h"
+#include "util/datastructures/ast/statements/ReturnStatementNode.hpp"
+#include "util/datastructures/ast/statements/WhileStatementNode.h"
+
+long ExpressionFolder::floor_div(long lhs, long rhs)
+{
+    auto quotient = lhs / rhs;
+    if ((lhs % rhs != 0) && ((lhs < 0) != (rhs < 0)))
+    {
+        quotient--;
+    }
+    return quotient;
+}
+
+long ExpressionFolder::floor_mod(long lhs, long rhs)
+{
+    auto remainder = lhs % rhs;
+    if ((remainder != 0) && ((remainder < 0) != (rhs < 0)))
+    {
+        remainder += rhs;
+    }
+    return remainder;
+}
+
+unsigned int ExpressionFolder::get_folded() const
+{
+    return folded_;
+}
+
+void ExpressionFolder::enter_scope(DeclarationsNode *declarations)
+{
+    auto &scope = scopes_.emplace_back();
+    if (!declarations)
+    {
+        return;
+    }
+
+    for (auto [ident, expr] : declarations->get_constants())
+    {
+        scope[ident->get_symbol()] = expr;
+    }
+    for (auto [ident, type] : declarations->get_typenames())
+    {
+        scope[ident->get_symbol()] = nullptr;
+    }
+    for (auto &[idents, type] : declarations->get_variables())
+    {
+        for (auto ident : idents)
+        {
+            scope[ident->get_symbol()] = nullptr;
+        }
+    }
+    for (auto procedure : declarations->get_procedures())
+    {
+        scope[procedure->get_names().first->get_symbol()] = nullptr;
+    }
+}
+
+ExpressionNode *ExpressionFolder::lookup_constant(IdentNode &ident)
+{
+    for (auto scope = scopes_.rbegin(); scope != scopes_.rend(); scope++)
+    {
+        auto declaration = scope->find(ident.get_symbol());
+        if (declaration != scope->end())
+        {
+            return declaration->second;
+        }
+    }
+    return nullptr;
+}
+
+void ExpressionFolder::fold_constants(ModuleNode &module)
+{
+    // imported constants are qualified ("M.x") and therefore never hidden by the module's own declarations
+    for (auto &[name, interface] : module.get_interfaces())
+    {
+        enter_scope(interface);
+    }
+    enter_scope(module.get_declarations());
+
+    if (module.get_declarations())
+    {
+        for (auto procedure : module.get_declarations()->get_procedures())
+        {
+            fold(*procedure);
+        }
+    }
+    fold(module.get_statements());
+
+    scopes_.clear();
+}
+
+void ExpressionFolder::fold(ProcedureDeclarationNode &procedure)
+{
+    enter_scope(procedure.get_declarations());
+    if (procedure.get_parameters())
+    {
+        for (auto &section : *procedure.get_parameters())
+        {
+            for (auto &param : *std::get<1>(*section))
+            {
+                scopes_.back()[param->get_symbol()] = nullptr;
+            }
+        }
+    }
+
+    if (procedure.get_declarations())
+    {
+        for (auto nested : procedure.get_declarations()->get_procedures())
+        {
+            fold(*nested);
+        }
+    }
+    fold(procedure.get_statements());
+
+    scopes_.pop_back();
+}
+
+void ExpressionFolder::fold(StatementSequenceNode *statements)
+{
+    if (!statements)
+    {
+        return;
+    }
+    for (auto &statement : *statements->get_statements())
+    {
+        fold(*statement);
+    }
+}
+
+void ExpressionFolder::fold(StatementNode &statement)
+{
+    switch (statement.getNodeType())
+    {
+    case NodeType::assignment:
+    {
+        auto &assignment = dynamic_cast<AssignmentNode &>(statement);
+        fold(assignment.get_selector());
+        if (auto literal = fold(*assignment.get_expr()))
+        {
+            assignment.set_expr(std::move(literal));
+        }
+        break;
+    }
+    case NodeType::if_statement:
+    {
+        auto &if_statement = dynamic_cast<IfStatementNode &>(statement);
+        if (auto literal = fold(*if_statement.get_condition()))
+        {
+            if_statement.set_condition(std::move(literal));
+        }
+        fold(if_statement.get_then());
+        for (auto &[condition, statements] : *if_statement.get_else_ifs())
+        {
+            if (auto literal = fold(*condition))
+            {
+                condition = std::move(literal);
+            }
+            fold(statements.get());
+        }
+        fold(if_statement.get_else());
+        break;
+    }
+    case NodeType::while_statement:
+    {
+        auto &while_statement = dynamic_cast<WhileStatementNode &>(statement);
+        if (auto literal = fold(*while_statement.get_expr()))
+        {
+            while_statement.set_expr(std::move(literal));
+        }
+        fold(while_statement.get_statements());
+        break;
+    }
+    case NodeType::repeat_statement:
+    {
+        auto &repeat_statement = dynamic_cast<RepeatStatementNode &>(statement);
+        fold(repeat_statement.get_statements());
+        if (auto literal = fold(*repeat_statement.get_expr()))
+        {
+            repeat_statement.set_expr(std::move(literal));
+        }
+        break;
+    }
+    case NodeType::procedure_call:
+    {
+        auto &call = dynamic_cast<ProcedureCallNode &>(statement);
+        fold(call.get_selector());
+        if (call.get_parameters())
+        {
+            for (auto &param : *call.get_parameters())
+            {
+                if (auto literal = fold(*param))
+                {
+                    param = std::move(literal);
+                }
+            }
+        }
+        break;
+    }
+    case NodeType::return_statement:
+    {
+        auto &return_statement = dynamic_cast<ReturnStatementNode &>(statement);
+        if (return_statement.get_value())
+        {
+            if (auto literal = fold(*return_statement.get_value()))
+            {
+                return_statement.set_value(std::move(literal));
+            }
+        }
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+void ExpressionFolder::fold(SelectorNode *selector)
+{
+    if (!selector || !selector->get_selector())
+    {
+        return;
+    }
+
+    auto &selectors = *selector->get_selector();
+    for (size_t i = 0; i < selectors.size(); i++)
+    {
+        if (std::get<0>(selectors[i]))
+        {
+            if (auto literal = fold(*std::get<2>(selectors[i])))
+            {
+                selector->set_index(i, std::move(literal));
+            }
+        }
+    }
+}
+
+std::unique_ptr<ExpressionNode> ExpressionFolder::fold(ExpressionNode &expr)
+{
+    switch (expr.getNodeType())
+    {
+    case NodeType::binary_expression:
+    {
+        auto &binary = dynamic_cast<BinaryExpressionNode &>(expr);
+        if (auto literal = fold(*binary.get_lhs()))
+        {
+            binary.set_lhs(std::move(literal));
+        }
+        if (auto literal = fold(*binary.get_rhs()))
+        {
+            binary.set_rhs(std::move(literal));
+        }
+
+        auto lhs = literal_value(*binary.get_lhs());
+        auto op = binary.get_op();
+
+        // the right operand of '&' and 'OR' is not evaluated if the left one decides the result
+        if (lhs && std::holds_alternative<bool>(*lhs) &&
+            ((op == SourceOperator::AND && !std::get<bool>(*lhs)) || (op == SourceOperator::OR && std::get<bool>(*lhs))))
+        {
+            return literal(*lhs, expr);
+        }
+
+        auto rhs = literal_value(*binary.get_rhs());
+        if (!lhs || !rhs)
+        {
+            return nullptr;
+        }
+        auto value = evaluate(op, *lhs, *rhs);
+        return value ? literal(*value, expr) : nullptr;
+    }
+    case NodeType::unary_expression:
+    {
+        auto &unary = dynamic_cast<UnaryExpressionNode &>(expr);
+        if (auto literal = fold(*unary.get_expr()))
+        {
+            unary.set_expr(std::move(literal));
+        }
+
+        auto operand = literal_value(*unary.get_expr());
+        if (!operand)
+        {
+            return nullptr;
+        }
+        auto value = evaluate(unary.get_op(), *operand);
+        return value ? literal(*value, expr) : nullptr;
+    }
+    case NodeType::ident_selector_expression:
+    {
+        auto &designator = dynamic_cast<IdentSelectorExpressionNode &>(expr);
+        if (designator.get_selector() && designator.get_selector()->get_selector())
+        {
+            fold(designator.get_selector());
+            return nullptr;
+        }
+
+        // only INTEGER constants can be declared, the checker has stored their values on the declaring expressions
+        auto constant = lookup_constant(*designator.get_identifier());
+        if (!constant || !constant->get_value())
+        {
+            return nullptr;
+        }
+        return literal(*constant->get_value(), expr);
+    }
+    case NodeType::procedure_call:
+    {
+        fold(*dynamic_cast<ProcedureCallExpressionNode &>(expr).get_call());
+        return nullptr;
+    }
+    default:
+        return nullptr;
+    }
+}
+
+std::optional<ExpressionFolder::Constant> ExpressionFolder::literal_value(ExpressionNode &expr)
+{
+    switch (expr.getNodeType())
+    {
+    case NodeType::integer:
+        return dynamic_cast<IntNode &>(expr).get_value();
+    case NodeType::real:
+        return dynamic_cast<FloatNode &>(expr).get_value();
+    case NodeType::boolean:
+        return dynamic_cast<BoolNode &>(expr).get_value();
+    case NodeType::character:
+        return dynamic_cast<CharNode &>(expr).get_value();
+    default:
+        return std::nullopt;
+    }
+}
+
+std::optional<ExpressionFolder::Constant> ExpressionFolder::evaluate(SourceOperator op, const Constant &lhs, const Constant &rhs)
+{
+    if (lhs.index() != rhs.index())
+    {
+        return std::nullopt;
+    }
+
+    if (std::holds_alternative<long>(lhs))
+    {
+        auto l = std::get<long>(lhs);
+        auto r = std::get<long>(rhs);
+        // INTEGER arithmetic wraps around like the generated code does
+        auto ul = static_cast<unsigned long>(l);
+        auto ur = static_cast<unsigned long>(r);
+        switch (op)
+        {
+        case SourceOperator::PLUS:
+            return static_cast<long>(ul + ur);
+        case SourceOperator::MINUS:
+            return static_cast<long>(ul - ur);
+        case SourceOperator::MULT:
+            return static_cast<long>(ul * ur);
+        case SourceOperator::DIV:
+        case SourceOperator::MOD:
+            if (r == 0 || (l == LONG_MIN && r == -1))
+            {
+                return std::nullopt;
+            }
+            return (op == SourceOperator::DIV) ? floor_div(l, r) : floor_mod(l, r);
+        case SourceOperator::EQ:
+            return l == r;
+        case SourceOperator::NEQ:
+            return l != r;
+        case SourceOperator::LT:
+            return l < r;
+        case SourceOperator::LEQ:
+            return l <= r;
+        case SourceOperator::GT:
+            return l > r;
+        case SourceOperator::GEQ:
+            return l >= r;
+        default:
+            return std::nullopt;
+        }
+    }
+
+    if (std::holds_alternative<double>(lhs))
+    {
+        // REAL is lowered to single precision, every operation rounds its result to it
+        auto l = static_cast<float>(std::get<double>(lhs));
+        auto r = static_cast<float>(std::get<double>(rhs));
+        switch (op)
+        {
+        case SourceOperator::PLUS:
+            return static_cast<double>(l + r);
+        case SourceOperator::MINUS:
+            return static_cast<double>(l - r);
+        case SourceOperator::MULT:
+            return static_cast<double>(l * r);
+        case SourceOperator::FLOAT_DIV:
+            return static_cast<double>(l / r);
+        case SourceOperator::EQ:
+            return l == r;
+        case SourceOperator::NEQ:
+            return l != r;
+        case SourceOperator::LT:
+            return l < r;
+        case SourceOperator::LEQ:
+            return l <= r;
+        case SourceOperator::GT:
+            return l > r;
+        case SourceOperator::GEQ:
+            return l >= r;
+        default:
+            return std::nullopt;
+        }
+    }
+
+    if (std::holds_alternative<bool>(lhs))
+    {
+        auto l = std::get<bool>(lhs);
+        auto r = std::get<bool>(rhs);
+        switch (op)
+        {
+        case SourceOperator::AND:
+            return l && r;
+        case SourceOperator::OR:
+            return l || r;
+        case SourceOperator::EQ:
+            return l == r;
+        case SourceOperator::NEQ:
+            return l != r;
+        default:
+            return std::nullopt;
+        }
+    }
+
+    // characters are ordered by their code
+    auto l = std::get<unsigned char>(lhs);
+    auto r = std::get<unsigned char>(rhs);
+    switch (op)
+    {
+    case SourceOperator::EQ:
+        return l == r;
+    case SourceOperator::NEQ:
+        return l != r;
+    case SourceOperator::LT:
+        return l < r;
+    case SourceOperator::LEQ:
+        return l <= r;
+    case SourceOperator::GT:
+        return l > r;
+    case SourceOperator::GEQ:
+        return l >= r;
+    default:
+        return std::nullopt;
+    }
+}
+
+std::optional<ExpressionFolder::Constant> ExpressionFolder::evaluate(SourceOperator op, const Constant &operand)
+{
+    switch (op)
+    {
+    case SourceOperator::NO_OPERATOR:
+    case SourceOperator::PAREN:
+        return operand;
+    case SourceOperator::NEG:
+        if (std::holds_alternative<long>(operand))
+        {
+            return static_cast<long>(0ul - static_cast<unsigned long>(std::get<long>(operand)));
+        }
+        if (std::holds_alternative<double>(operand))
+        {
+            return -std::get<double>(operand);
+        }
+        return std::nullopt;
+    case SourceOperator::NOT:
+        if (std::holds_alternative<bool>(operand))
+        {
+            return !std::get<bool>(operand);
+        }
+        return std::nullopt;
+    default:
+        return std::nullopt;
+    }
+}
+
+std::unique_ptr<ExpressionNode> ExpressionFolder::literal(const Constant &value, ExpressionNode &replaced)
+{
+    std::unique_ptr<ExpressionNode> node;
+    if (std::holds_alternative<long>(value))
+    {
+        node = std::make_unique<IntNode>(replaced.pos(), std::get<long>(value));
+        node->set_value(std::get<long>(value));
+    }
+    else if (std::holds_alternative<double>(value))
+    {
+        node = std::make_unique<FloatNode>(replaced.pos(), std::get<double>(value));
+    }
+    else if (std::holds_alternative<bool>(value))
+    {
+        node = std::make_unique<BoolNode>(replaced.pos(), std::get<bool>(value));
+    }
+    else
+    {
+        node = std::make_unique<CharNode>(replaced.pos(), std::get<unsigned char>(value));
+    }
+    node->set_types(replaced.get_formal_type(), replaced.get_actual_type());
+    folded_++;
+    return node;
+}
@@ -0,0 +1,71 @@
+//
+// Created by M on 17.10.2026.
+//
+
+#ifndef OBERON0C_EXPRESSIONFOLDER_H
+#define OBERON0C_EXPRESSIONFOLDER_H
+
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+#include "util/Symbol.h"
+#include "util/datastructures/ast/ModuleNode.h"
+#include "util/datastructures/ast/base_blocks/ExpressionNode.h"
+#include "util/datastructures/ast/base_blocks/IdentNode.h"
+#include "util/datastructures/ast/base_blocks/SelectorNode.h"
+#include "util/datastructures/ast/declarations/DeclarationsNode.h"
+#include "util/datastructures/ast/declarations/ProcedureDeclarationNode.h"
+#include "util/datastructures/ast/statements/StatementNode.h"
+#include "util/datastructures/ast/statements/StatementSequenceNode.h"
+
+/*
+ *  Replaces the constant subexpressions of a checked module by literals, so that the code generator emits constants
+ *  instead of instructions (which matters most for unoptimized builds). Operands are literals of the scalar types
+ *  (INTEGER, REAL, BOOLEAN, CHAR) and named constants. Operations are evaluated with the semantics of the generated
+ *  code: INTEGER arithmetic wraps around, DIV and MOD round towards negative infinity and REAL arithmetic is done in
+ *  single precision. Operations that would trap at runtime (DIV or MOD by zero, dividing the smallest INTEGER by -1)
+ *  are left in place.
+ *  Declarations are left as they are, the checker has already evaluated constant values and array sizes.
+ */
+class ExpressionFolder
+{
+
+private:
+    using Constant = std::variant<long, double, bool, unsigned char>;
+
+    // names declared by the enclosing scopes, mapped to the declaring expression of constants and to nullptr for all
+    // other declarations (which hide constants of the same name declared further out)
+    std::vector<std::unordered_map<Symbol, ExpressionNode *>> scopes_;
+    unsigned int folded_ = 0;
+
+    void enter_scope(DeclarationsNode *declarations);
+    ExpressionNode *lookup_constant(IdentNode &ident);
+
+    void fold(ProcedureDeclarationNode &procedure);
+    void fold(StatementSequenceNode *statements);
+    void fold(StatementNode &statement);
+    void fold(SelectorNode *selector);
+    // returns the literal that replaces the expression, nullptr if the expression is a literal already or not constant
+    // (its constant subexpressions are replaced either way)
+    std::unique_ptr<ExpressionNode> fold(ExpressionNode &expr);
+
+    static std::optional<Constant> literal_value(ExpressionNode &expr);
+    static std::optional<Constant> evaluate(SourceOperator op, const Constant &lhs, const Constant &rhs);
+    static std::optional<Constant> evaluate(SourceOperator op, const Constant &operand);
+    std::unique_ptr<ExpressionNode> literal(const Constant &value, ExpressionNode &replaced);
+
+public:
+    void fold_constants(ModuleNode &module);
+
+    // number of expressions replaced by literals
+    [[nodiscard]] unsigned int get_folded() const;
+
+    // Oberon's DIV and MOD: the quotient is rounded towards negative infinity, the remainder has the sign of the divisor
+    static long floor_div(long lhs, long rhs);
+    static long floor_mod(long lhs, long rhs);
+};
+
+#endif //OBERON0C_EXPRESSIONFOLDER_H
@@ -3,9 +3,11 @@
 //
 
 #include "SemanticChecker.h"
+#include "ExpressionFolder.h"
+#include "SymbolFile.h"
 #include "util/panic.h"
 
-SemanticChecker::SemanticChecker(Logger &logger) : logger_(logger)
+SemanticChecker::SemanticChecker(Logger &logger, std::vector<string> import_paths) : logger_(logger), import_paths_(std::move(import_paths))
 {
     scope_table_ = ScopeTable();
     current_procedure_ = std::nullopt;
@@ -237,6 +239,13 @@ std::shared_ptr<TypeInfo> SemanticChecker::checkType(ExpressionNode &expr)
 std::optional<long> SemanticChecker::evaluate_expression(ExpressionNode &expr, bool suppress_errors)
 {
 
+    // Values are stored on the expressions once known, named constants referring to other named constants are thus
+    // evaluated only once instead of once per reference
+    if (auto value = expr.get_value())
+    {
+        return value;
+    }
+
     auto type = expr.getNodeType();
 
     if (type == NodeType::binary_expression)
@@ -257,14 +266,18 @@ std::optional<long> SemanticChecker::evaluate_expression(ExpressionNode &expr, b
         case SourceOperator::MINUS:
             return lhs.value() - rhs.value();
         case SourceOperator::MOD:
-            return (lhs.value() % rhs.value());
         case SourceOperator::DIV:
             if (rhs.value() == 0)
             {
                 logger_.error(expr.pos(), "Division by zero.");
                 return std::nullopt;
             }
-            return lhs.value() / rhs.value();
+            if (lhs.value() == std::numeric_limits<long>::min() && rhs.value() == -1)
+            {
+                logger_.error(expr.pos(), "Integer overflow in division.");
+                return std::nullopt;
+            }
+            return (op == SourceOperator::DIV) ? ExpressionFolder::floor_div(lhs.value(), rhs.value()) : ExpressionFolder::floor_mod(lhs.value(), rhs.value());
         case SourceOperator::MULT:
             return lhs.value() * rhs.value();
         case SourceOperator::PLUS:
@@ -313,7 +326,7 @@ std::optional<long> SemanticChecker::evaluate_expression(ExpressionNode &expr, b
             return std::nullopt;
         }
 
-        auto id_info = scope_table_.lookup(id_sel_expr->get_identifier()->get_value());
+        auto id_info = scope_table_.lookup(id_sel_expr->get_identifier()->get_symbol());
         if (!id_info)
         {
             if (!suppress_errors)
@@ -342,8 +355,13 @@ std::optional<long> SemanticChecker::evaluate_expression(ExpressionNode &expr, b
             return std::nullopt;
         }
 
-        auto constant_expr = dynamic_cast<const ExpressionNode *>(id_info->node);
-        return evaluate_expression(const_cast<ExpressionNode &>(*constant_expr), suppress_errors);
+        auto constant_expr = const_cast<ExpressionNode *>(dynamic_cast<const ExpressionNode *>(id_info->node));
+        auto value = evaluate_expression(*constant_expr, suppress_errors);
+        if (value)
+        {
+            constant_expr->set_value(value.value());
+        }
+        return value;
     }
     else if (type == NodeType::procedure_call){
         return std::nullopt;
@@ -383,7 +401,7 @@ std::shared_ptr<TypeInfo> SemanticChecker::check_selector_type(IdentSelectorExpr
     auto selector = id_expr.get_selector();
 
     // check if identifier is defined
-    auto identifier_info = scope_table_.lookup(identifier->get_value());
+    auto identifier_info = scope_table_.lookup(identifier->get_symbol());
     if (!identifier_info)
     {
         report_unknown_identifier(id_expr.pos(),identifier->get_value());
@@ -445,7 +463,7 @@ std::shared_ptr<TypeInfo> SemanticChecker::trace_type(std::shared_ptr<TypeInfo>
 //                  * Identifier must refer to an actual field of that record type
 std::shared_ptr<TypeInfo> SemanticChecker::check_selector_chain(IdentNode &ident, SelectorNode &selector)
 {
-    IdentInfo *prev_info = scope_table_.lookup(ident.get_value());
+    IdentInfo *prev_info = scope_table_.lookup(ident.get_symbol());
     if(!prev_info){
         report_unknown_identifier(ident.pos(),ident.get_value());
         return error_type;
@@ -493,7 +511,7 @@ std::shared_ptr<TypeInfo> SemanticChecker::check_selector_chain(IdentNode &ident
             if (evaluated_dim)
             {
                 expr->set_value(evaluated_dim.value());
-                if (evaluated_dim.value() > dim)
+                if (evaluated_dim.value() < 0 || evaluated_dim.value() >= dim)
                 {
                     logger_.error(selector.pos(), "Array index out of bounds (index " + to_string(evaluated_dim.value()) + " for size " + to_string(dim) + ").");
                 }
@@ -545,15 +563,16 @@ std::shared_ptr<TypeInfo> SemanticChecker::check_selector_chain(IdentNode &ident
             }
 
             // Identifier must refer to an actual field of that record type
-            auto field_type = scope_table_.lookup_field(prev_type->name, std::get<1>(*itr)->get_value());
-            if (!field_type || field_type->tag == ERROR_TAG)
+            auto &record = std::get<RecordTypeInfo>(trace_type(prev_type)->extended_info.value());
+            auto field = record.field(std::get<1>(*itr)->get_symbol());
+            if (!field || field->type->tag == ERROR_TAG)
             {
                 logger_.error(selector.pos(), "Tried to access invalid field of record type '" + prev_type->name + "' (Field: " + std::get<1>(*itr)->get_value() + ").");
                 return error_type;
             }
 
             // Update prev_type
-            prev_type = field_type;
+            prev_type = field->type;
         }
     }
 
@@ -612,25 +631,13 @@ std::shared_ptr<TypeInfo> SemanticChecker::create_new_type(TypeNode &type, strin
     //      --> Types of the fields must be valid
     else if(type.getNodeType() == NodeType::record_type){
         auto record_node = &dynamic_cast<RecordTypeNode&>(type);
-        auto field_map = key_value_map(*record_node);               // Note: This function also handles some recordType errors
+        auto fields = record_fields(*record_node);               // Note: This function also handles some recordType errors
 
         // Insert record type into table
-        auto record_type = (insert_into_table)? scope_table_.insert_type(type_name,field_map) : std::make_shared<TypeInfo>(type_name,RECORD,RecordTypeInfo(field_map));
+        auto record_type = (insert_into_table)? scope_table_.insert_type(type_name,fields) : std::make_shared<TypeInfo>(type_name,RECORD,RecordTypeInfo(fields));
 
-        // Insert Traced Record Types into RecordTypeNode
-        auto field_map_opt = scope_table_.lookup_record(type_name);
-        if (field_map_opt)
-        {
-            auto fields = field_map_opt.value();
-
-            // Trace Types
-            for (auto fitr = field_map.begin(); fitr != field_map.end(); fitr++)
-            {
-                fitr->second = trace_type(fitr->second);
-            }
-
-            record_node->insert_field_types(fields);
-        }
+        // The RecordTypeNode shares the layout with the type table
+        record_node->set_record_type(record_type);
 
         return record_type;
     }
@@ -648,9 +655,46 @@ std::shared_ptr<TypeInfo> SemanticChecker::create_new_type(TypeNode &type, strin
     panic("Invalid NodeType passed as TypeNode!");
 }
 
+// Loads the symbol file of a module (after those of the modules its interface refers to) and declares its exports
+void SemanticChecker::load_interface(Symbol name, FilePos pos, ModuleNode &module)
+{
+    // Every interface is declared once, even if several imported interfaces refer to it
+    if (!loaded_interfaces_.insert(name).second)
+    {
+        return;
+    }
+
+    auto path = SymbolFile::find(name, import_paths_);
+    if (path.empty())
+    {
+        logger_.error(pos, "No symbol file found for module '" + name.str() + "' (modules have to be compiled before they are imported, and only modules exporting declarations can be imported).");
+        return;
+    }
+
+    auto interface = SymbolFile::read(path, pos, logger_);
+    if (!interface)
+    {
+        return;
+    }
+    if (interface->name != name)
+    {
+        logger_.error(pos, "Symbol file '" + path + "' describes module '" + interface->name.str() + "' instead of module '" + name.str() + "'.");
+        return;
+    }
+
+    for (auto required : interface->imports)
+    {
+        load_interface(required, pos, module);
+    }
+
+    visit(*interface->declarations);
+    module.add_interface(name, std::move(interface->declarations));
+}
+
 // Module:
 //      --> The beginning and ending names should align
 //      --> A module opens a new scope
+//      --> Imported modules must have a symbol file, a module cannot import itself or the same module twice
 void SemanticChecker::visit(ModuleNode &module)
 {
 
@@ -666,17 +710,37 @@ void SemanticChecker::visit(ModuleNode &module)
 
     auto names = module.get_name();
 
-    if (names.first->get_value() != names.second->get_value())
+    if (names.first->get_symbol() != names.second->get_symbol())
     {
         logger_.error(module.pos(), "Beginning and ending names of module are unequal: \"" + names.first->get_value() + "\" and \"" + names.second->get_value() + "\".");
     }
 
+    // declare the exports of imported modules under their qualified names
+    for (auto import : module.get_imports())
+    {
+        if (import->get_symbol() == names.first->get_symbol())
+        {
+            logger_.error(import->pos(), "Module '" + import->get_value() + "' cannot import itself.");
+        }
+        else if (!imported_modules_.insert(import->get_symbol()).second)
+        {
+            logger_.error(import->pos(), "Module '" + import->get_value() + "' is imported more than once.");
+        }
+        else
+        {
+            load_interface(import->get_symbol(), import->pos(), module);
+        }
+    }
+
     // validate declarations
     visit(*module.get_declarations());
 
     // validate statements
     current_procedure_ = std::nullopt;
-    visit(*module.get_statements());
+    if (module.get_statements())
+    {
+        visit(*module.get_statements());
+    }
 
     scope_table_.endScope();
 }
@@ -689,16 +753,17 @@ void SemanticChecker::visit(ProcedureDeclarationNode &procedure)
 {
 
     auto names = procedure.get_names();
-    if (names.first->get_value() != names.second->get_value())
+    if (names.first->get_symbol() != names.second->get_symbol())
     {
         logger_.error(procedure.pos(), "Beginning and ending names of procedure are unequal: \"" + names.first->get_value() + "\" and \"" + names.second->get_value() + "\".");
     }
 
     // Check for double declarations
-    if (scope_table_.lookup(names.first->get_value(), true))
+    if (scope_table_.lookup(names.first->get_symbol(), true))
     {
         logger_.error(procedure.pos(), "Multiple declarations for procedure '" + names.first->get_value() + "' found (Note: Oberon0 does not allow overloading functions).");
     }
+    check_declared_name(*names.first);
 
     auto prev_procedure = current_procedure_;
     current_procedure_ = names.first->get_value();
@@ -711,7 +776,7 @@ void SemanticChecker::visit(ProcedureDeclarationNode &procedure)
     }
 
     // Save the procedure name (before opening up a new scope!)
-    scope_table_.insert(names.first->get_value(), Kind::PROCEDURE, &procedure, return_type);
+    scope_table_.insert(names.first->get_symbol(), Kind::PROCEDURE, &procedure, return_type);
 
     // Open up new scope
     scope_table_.beginScope();
@@ -751,13 +816,14 @@ void SemanticChecker::visit(ProcedureDeclarationNode &procedure)
             {
 
                 // Check for double definitions
-                if (scope_table_.lookup(var->get()->get_value(), true))
+                if (scope_table_.lookup(var->get()->get_symbol(), true))
                 {
                     logger_.error(var->get()->pos(), "Multiple use of the same parameter name.");
                 }
 
+                check_declared_name(**var);
                 var->get()->set_types(var_type, trace_type(var_type));
-                scope_table_.insert(var->get()->get_value(), Kind::VARIABLE, var->get(), var_type);
+                scope_table_.insert(var->get()->get_symbol(), Kind::VARIABLE, var->get(), var_type);
             }
         }
     }
@@ -765,8 +831,11 @@ void SemanticChecker::visit(ProcedureDeclarationNode &procedure)
     // Check declarations
     visit(*procedure.get_declarations());
 
-    // Check statements
-    visit(*procedure.get_statements());
+    // Check statements (imported procedures have none)
+    if (procedure.get_statements())
+    {
+        visit(*procedure.get_statements());
+    }
 
     scope_table_.endScope();
     current_procedure_ = prev_procedure;
@@ -789,10 +858,11 @@ void SemanticChecker::visit(DeclarationsNode &declars)
     {
 
         // check for double declarations (only in current scope)
-        if (scope_table_.lookup_name(itr->first->get_value(), true))
+        if (scope_table_.lookup_name(itr->first->get_symbol(), true))
         {
             logger_.error(declars.pos(), "Multiple declarations of identifier '" + itr->first->get_value() + "'.");
         }
+        check_declared_name(*itr->first);
 
         // check if expression actually evaluates to a constant
         auto evaluated_value = evaluate_expression(*itr->second);
@@ -808,7 +878,7 @@ void SemanticChecker::visit(DeclarationsNode &declars)
         // insert variable into scope table
         auto const_type = checkType(*itr->second);
         itr->first->set_types(const_type, trace_type(const_type));
-        scope_table_.insert(itr->first->get_value(), Kind::CONSTANT, itr->second, const_type);
+        scope_table_.insert(itr->first->get_symbol(), Kind::CONSTANT, itr->second, const_type);
     }
 
     // Typenames
@@ -817,7 +887,7 @@ void SemanticChecker::visit(DeclarationsNode &declars)
     {
 
         // check for double declarations
-        if (scope_table_.lookup(itr->first->get_value(), true))
+        if (scope_table_.lookup(itr->first->get_symbol(), true))
         {
             if(itr->first->get_value() == int_string || itr->first->get_value() == bool_string || itr->first->get_value() == float_string || itr->first->get_value() == char_string || itr->first->get_value() == str_string || itr->first->get_value() == nil_string){
                 logger_.error(declars.pos(), "Attempt to redefine predefined type '" + itr->first->get_value() + "'.");
@@ -826,6 +896,7 @@ void SemanticChecker::visit(DeclarationsNode &declars)
             }
 
         }
+        check_declared_name(*itr->first);
 
         // check the type definition and insert into scope table
         auto type = create_new_type(*itr->second, itr->first->get_value(),true);
@@ -848,7 +919,7 @@ void SemanticChecker::visit(DeclarationsNode &declars)
         // Correctly Assign TypeNode
         if (itr->second->getNodeType() == NodeType::ident)
         {
-            var_type = scope_table_.lookup_type(dynamic_cast<IdentNode *>(itr->second)->get_value());
+            var_type = scope_table_.lookup_type(dynamic_cast<IdentNode *>(itr->second)->get_symbol());
         }
         else
         {
@@ -859,14 +930,19 @@ void SemanticChecker::visit(DeclarationsNode &declars)
         {
 
             // check for double declarations (only in current scope)
-            if (scope_table_.lookup_name((*el)->get_value(), true))
+            if (scope_table_.lookup_name((*el)->get_symbol(), true))
             {
                 logger_.error(declars.pos(), "Multiple Declarations of identifier '" + (*el)->get_value() + "'.");
             }
+            if ((*el)->is_exported())
+            {
+                logger_.error((*el)->pos(), "Variable '" + (*el)->get_value() + "' cannot be exported (only constants, types and procedures can).");
+            }
+            check_declared_name(**el);
 
             // insert variable into symbol table
             (*el)->set_types(var_type, trace_type(var_type));
-            scope_table_.insert((*el)->get_value(), Kind::VARIABLE, itr->second, var_type);
+            scope_table_.insert((*el)->get_symbol(), Kind::VARIABLE, itr->second, var_type);
         }
     }
 
@@ -877,11 +953,11 @@ void SemanticChecker::visit(DeclarationsNode &declars)
     }
 }
 
-// Fills a key-value-map-vector which is needed to place record types into the scope table
-std::map<string,std::shared_ptr<TypeInfo>> SemanticChecker::key_value_map(RecordTypeNode &node)
+// Collects the fields of a record type in declaration order, which is needed to place record types into the scope table
+field_decls SemanticChecker::record_fields(RecordTypeNode &node)
 {
     scope_table_.beginScope();
-    std::map<string,std::shared_ptr<TypeInfo>> key_value_map;
+    field_decls record_fields;
 
     auto fields = node.get_fields();
     for (auto field_itr = fields.begin(); field_itr != fields.end(); field_itr++)
@@ -897,17 +973,19 @@ std::map<string,std::shared_ptr<TypeInfo>> SemanticChecker::key_value_map(Record
             {
                 logger_.error(node.pos(), "Multiple definitions of record field '" + *field_name + "'.");
             }
+            else
+            {
+                record_fields.emplace_back(*field_name, field_type);
+            }
 
             // Note: Since this scope is only used to check for double definitions and immediately closed after that,
             //       It doesn't *really* matter what we put into the scope table for the fields
             scope_table_.insert(*field_name, Kind::VARIABLE, nullptr, error_type);
-
-            key_value_map[*field_name] = field_type;
         }
     }
 
     scope_table_.endScope();
-    return key_value_map;
+    return record_fields;
 }
 
 // StatementSequence:
@@ -1121,7 +1199,7 @@ void SemanticChecker::visit(ProcedureCallNode &node)
 
     // Check Name
     auto ident = node.get_ident();
-    auto ident_info = scope_table_.lookup(ident->get_value());
+    auto ident_info = scope_table_.lookup(ident->get_symbol());
 
     if (!ident_info)
     {
@@ -1144,7 +1222,7 @@ void SemanticChecker::visit(ProcedureCallNode &node)
     }
 
     // Save Name in AST
-    node.set_name(ident->get_value());
+    node.set_name(ident->get_symbol());
 
     // Get Function declaration
     auto *procedure_decl = dynamic_cast<ProcedureDeclarationNode *>(ident_info->node);
@@ -1236,6 +1314,19 @@ void SemanticChecker::validate_program(ModuleNode &node)
     visit(node);
 }
 
+// Declared names must not hide imported modules (a qualified identifier "M.x" would be ambiguous otherwise) and only
+// declarations at module level can be exported
+void SemanticChecker::check_declared_name(IdentNode &ident) {
+    if (imported_modules_.contains(ident.get_symbol()))
+    {
+        logger_.error(ident.pos(), "Identifier '" + ident.get_value() + "' is already the name of an imported module.");
+    }
+    if (ident.is_exported() && current_procedure_.has_value())
+    {
+        logger_.error(ident.pos(), "Only declarations at module level can be exported ('" + ident.get_value() + "').");
+    }
+}
+
 void SemanticChecker::report_unknown_identifier(FilePos pos, string id_name, bool variable_wanted) {
     if(variable_wanted && scope_table_.lookup_type(id_name)){
         logger_.error(pos,"Identifier '" + id_name+ "' refers to a type and not to a variable.");
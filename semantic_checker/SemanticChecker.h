@@ -8,6 +8,7 @@
 #include <limits>
 #include <optional>
 #include <cmath>
+#include <unordered_set>
 
 #include "util/datastructures/tables/ScopeTable.h"
 #include "util/Logger.h"
@@ -22,6 +23,11 @@ class SemanticChecker : NodeVisitor {
         // Current procedure that is being evaluated (nullopt for the "Main" function of a module)
         std::optional<string> current_procedure_;
 
+        // Directories searched for the symbol files of imported modules
+        std::vector<string> import_paths_;
+        std::unordered_set<Symbol> imported_modules_;
+        std::unordered_set<Symbol> loaded_interfaces_;
+
         inline static const string int_string = "INTEGER";
         inline static const string bool_string = "BOOLEAN";
         inline static const string float_string = "REAL";
@@ -37,9 +43,11 @@ class SemanticChecker : NodeVisitor {
         inline static std::shared_ptr<TypeInfo> nil_type     = std::make_shared<TypeInfo>(nil_string,NIL);
 
         void report_unknown_identifier(FilePos pos, string id_name, bool variable_wanted = true);
+        void check_declared_name(IdentNode &ident);
+        void load_interface(Symbol name, FilePos pos, ModuleNode &module);
 
     public:
-        explicit SemanticChecker(Logger& logger);
+        explicit SemanticChecker(Logger& logger, std::vector<string> import_paths = {});
 
         // Base Blocks/Empty Definitions
         void visit(IntNode&) override;
@@ -75,7 +83,7 @@ class SemanticChecker : NodeVisitor {
         void visit(ProcedureCallNode&) override;
 
         // Record fields
-        std::map<string,std::shared_ptr<TypeInfo>> key_value_map(RecordTypeNode&);
+        field_decls record_fields(RecordTypeNode&);
 
         // Typechecking
         std::shared_ptr<TypeInfo> create_new_type(TypeNode &type, string type_name, bool insert_into_table);
@@ -0,0 +1,525 @@
+//
+// Created by M on 17.10.2026.
+//
+
+#include "SymbolFile.h"
+
+#include <algorithm>
+#include <iterator>
+#include <unordered_map>
+
+#include <llvm/Support/Endian.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include "util/datastructures/ast/base_blocks/IdentNode.h"
+#include "util/datastructures/ast/base_blocks/LiteralNodes.h"
+#include "util/datastructures/ast/declarations/ArrayTypeNode.h"
+#include "util/datastructures/ast/declarations/PointerTypeNode.hpp"
+#include "util/datastructures/ast/declarations/ProcedureDeclarationNode.h"
+#include "util/datastructures/ast/declarations/RecordTypeNode.h"
+#include "util/panic.h"
+
+namespace {
+
+    const char symbol_file_magic[4] = {'O', 'S', 'Y', 'M'};
+    const uint32_t symbol_file_version = 1;
+
+    enum class TypeDescription : uint8_t
+    {
+        name,
+        array,
+        record,
+        pointer
+    };
+
+    class SymbolFileWriter
+    {
+
+    private:
+        Symbol module_;
+        Logger &logger_;
+        std::string body_;
+        std::vector<Symbol> imports_;
+        // module-level type declarations and whether they are exported
+        std::unordered_map<Symbol, bool> types_;
+        bool valid_ = true;
+
+        static void u8(std::string &out, uint8_t value)
+        {
+            out.push_back(static_cast<char>(value));
+        }
+
+        static void u32(std::string &out, uint32_t value)
+        {
+            char bytes[4];
+            llvm::support::endian::write32le(bytes, value);
+            out.append(bytes, 4);
+        }
+
+        static void i64(std::string &out, int64_t value)
+        {
+            char bytes[8];
+            llvm::support::endian::write64le(bytes, static_cast<uint64_t>(value));
+            out.append(bytes, 8);
+        }
+
+        static void str(std::string &out, const std::string &value)
+        {
+            u32(out, static_cast<uint32_t>(value.size()));
+            out.append(value);
+        }
+
+        [[nodiscard]] std::string qualified(IdentNode &ident) const
+        {
+            return module_.str() + "." + ident.get_value();
+        }
+
+        // Type references are qualified, references to types of other modules make these modules imports of the interface
+        void type_name(IdentNode &ident, IdentNode &declaration)
+        {
+            const auto &name = ident.get_value();
+            auto qualifier = name.find('.');
+            if (qualifier != std::string::npos)
+            {
+                Symbol module = name.substr(0, qualifier);
+                if (std::find(imports_.begin(), imports_.end(), module) == imports_.end())
+                {
+                    imports_.push_back(module);
+                }
+                str(body_, name);
+                return;
+            }
+
+            auto declared = types_.find(ident.get_symbol());
+            if (declared == types_.end())
+            {
+                // predefined type
+                str(body_, name);
+            }
+            else if (declared->second)
+            {
+                str(body_, qualified(ident));
+            }
+            else
+            {
+                logger_.error(declaration.pos(), "Exported declaration '" + declaration.get_value() + "' refers to the non-exported type '" + name + "'.");
+                valid_ = false;
+            }
+        }
+
+        void type(TypeNode &node, IdentNode &declaration)
+        {
+            switch (node.getNodeType())
+            {
+            case NodeType::ident:
+                u8(body_, static_cast<uint8_t>(TypeDescription::name));
+                type_name(dynamic_cast<IdentNode &>(node), declaration);
+                break;
+            case NodeType::array_type:
+            {
+                auto &array = dynamic_cast<ArrayTypeNode &>(node);
+                u8(body_, static_cast<uint8_t>(TypeDescription::array));
+                i64(body_, array.get_dim().value_or(0));
+                type(*array.get_type_node(), declaration);
+                break;
+            }
+            case NodeType::record_type:
+            {
+                auto fields = dynamic_cast<RecordTypeNode &>(node).get_fields();
+                u8(body_, static_cast<uint8_t>(TypeDescription::record));
+                u32(body_, static_cast<uint32_t>(fields.size()));
+                for (auto &[names, field_type] : fields)
+                {
+                    u32(body_, static_cast<uint32_t>(names.size()));
+                    for (auto &name : names)
+                    {
+                        str(body_, name);
+                    }
+                    type(*field_type, declaration);
+                }
+                break;
+            }
+            case NodeType::pointer_type:
+                u8(body_, static_cast<uint8_t>(TypeDescription::pointer));
+                type(*dynamic_cast<PointerTypeNode &>(node).get_pointee_typenode(), declaration);
+                break;
+            default:
+                panic("Invalid NodeType passed as TypeNode!");
+            }
+        }
+
+    public:
+        SymbolFileWriter(Symbol module, Logger &logger) : module_(module), logger_(logger) {};
+
+        bool describe(DeclarationsNode &declarations, std::string &out)
+        {
+            auto typenames = declarations.get_typenames();
+            for (auto &[ident, type_node] : typenames)
+            {
+                types_[ident->get_symbol()] = ident->is_exported();
+            }
+
+            std::vector<std::pair<IdentNode *, TypeNode *>> exported_types;
+            std::copy_if(typenames.begin(), typenames.end(), std::back_inserter(exported_types), [](auto &type) { return type.first->is_exported(); });
+            u32(body_, static_cast<uint32_t>(exported_types.size()));
+            for (auto &[ident, type_node] : exported_types)
+            {
+                str(body_, qualified(*ident));
+                type(*type_node, *ident);
+            }
+
+            std::vector<std::pair<IdentNode *, ExpressionNode *>> exported_constants;
+            auto constants = declarations.get_constants();
+            std::copy_if(constants.begin(), constants.end(), std::back_inserter(exported_constants), [](auto &constant) { return constant.first->is_exported(); });
+            u32(body_, static_cast<uint32_t>(exported_constants.size()));
+            for (auto &[ident, expr] : exported_constants)
+            {
+                str(body_, qualified(*ident));
+                i64(body_, expr->get_value().value_or(0));
+            }
+
+            std::vector<ProcedureDeclarationNode *> exported_procedures;
+            auto procedures = declarations.get_procedures();
+            std::copy_if(procedures.begin(), procedures.end(), std::back_inserter(exported_procedures), [](auto procedure) { return procedure->get_names().first->is_exported(); });
+            u32(body_, static_cast<uint32_t>(exported_procedures.size()));
+            for (auto procedure : exported_procedures)
+            {
+                auto &ident = *procedure->get_names().first;
+                str(body_, qualified(ident));
+
+                u8(body_, procedure->get_return_type_node() != nullptr);
+                if (procedure->get_return_type_node())
+                {
+                    type(*procedure->get_return_type_node(), ident);
+                }
+
+                auto params = procedure->get_parameters();
+                u32(body_, params ? static_cast<uint32_t>(params->size()) : 0);
+                if (params)
+                {
+                    for (auto &section : *params)
+                    {
+                        auto &[is_var, names, type_node] = *section;
+                        u8(body_, is_var);
+                        u32(body_, static_cast<uint32_t>(names->size()));
+                        for (auto &name : *names)
+                        {
+                            str(body_, name->get_value());
+                        }
+                        type(*type_node, ident);
+                    }
+                }
+            }
+
+            if (!valid_)
+            {
+                return false;
+            }
+
+            out.append(symbol_file_magic, sizeof(symbol_file_magic));
+            u32(out, symbol_file_version);
+            str(out, module_.str());
+            u32(out, static_cast<uint32_t>(imports_.size()));
+            for (auto module : imports_)
+            {
+                str(out, module.str());
+            }
+            out.append(body_);
+            return true;
+        }
+    };
+
+    // Reads a symbol file that has been mapped into memory, any inconsistency marks the file as damaged
+    class SymbolFileReader
+    {
+
+    private:
+        llvm::StringRef data_;
+        FilePos pos_;
+        bool valid_ = true;
+
+        bool available(size_t bytes)
+        {
+            if (data_.size() < bytes)
+            {
+                valid_ = false;
+                data_ = "";
+            }
+            return valid_;
+        }
+
+        uint8_t u8()
+        {
+            if (!available(1))
+            {
+                return 0;
+            }
+            auto value = static_cast<uint8_t>(data_.front());
+            data_ = data_.drop_front(1);
+            return value;
+        }
+
+        uint32_t u32()
+        {
+            if (!available(4))
+            {
+                return 0;
+            }
+            auto value = llvm::support::endian::read32le(data_.data());
+            data_ = data_.drop_front(4);
+            return value;
+        }
+
+        int64_t i64()
+        {
+            if (!available(8))
+            {
+                return 0;
+            }
+            auto value = static_cast<int64_t>(llvm::support::endian::read64le(data_.data()));
+            data_ = data_.drop_front(8);
+            return value;
+        }
+
+        std::string str()
+        {
+            auto size = u32();
+            if (!available(size))
+            {
+                return "";
+            }
+            auto value = data_.take_front(size).str();
+            data_ = data_.drop_front(size);
+            return value;
+        }
+
+        // Every element of a list takes at least one byte, which bounds the length of intact lists
+        uint32_t count()
+        {
+            auto value = u32();
+            return available(value) ? value : 0;
+        }
+
+        std::unique_ptr<std::vector<std::unique_ptr<IdentNode>>> names()
+        {
+            auto idents = std::make_unique<std::vector<std::unique_ptr<IdentNode>>>();
+            for (auto n = count(); n > 0; n--)
+            {
+                idents->emplace_back(std::make_unique<IdentNode>(pos_, str()));
+            }
+            return idents;
+        }
+
+        std::unique_ptr<TypeNode> type()
+        {
+            switch (static_cast<TypeDescription>(u8()))
+            {
+            case TypeDescription::name:
+                return std::make_unique<IdentNode>(pos_, str());
+            case TypeDescription::array:
+            {
+                auto size = i64();
+                return std::make_unique<ArrayTypeNode>(pos_, std::make_unique<IntNode>(pos_, size), type());
+            }
+            case TypeDescription::record:
+            {
+                auto field_lists = count();
+                if (field_lists == 0)
+                {
+                    valid_ = false;
+                    return nullptr;
+                }
+                std::unique_ptr<RecordTypeNode> record;
+                for (; field_lists > 0 && valid_; field_lists--)
+                {
+                    auto field_names = names();
+                    auto field_type = type();
+                    auto field_list = std::make_unique<field>(std::move(field_names), std::move(field_type));
+                    if (!record)
+                    {
+                        record = std::make_unique<RecordTypeNode>(pos_, std::move(field_list));
+                    }
+                    else
+                    {
+                        record->add_field_list(std::move(field_list));
+                    }
+                }
+                return record;
+            }
+            case TypeDescription::pointer:
+                return std::make_unique<PointerTypeNode>(pos_, type());
+            default:
+                valid_ = false;
+                return nullptr;
+            }
+        }
+
+    public:
+        SymbolFileReader(llvm::StringRef data, FilePos pos) : data_(data), pos_(pos) {};
+
+        bool header(ModuleInterface &interface)
+        {
+            if (!available(sizeof(symbol_file_magic)) || data_.take_front(sizeof(symbol_file_magic)) != llvm::StringRef(symbol_file_magic, sizeof(symbol_file_magic)))
+            {
+                return false;
+            }
+            data_ = data_.drop_front(sizeof(symbol_file_magic));
+            if (u32() != symbol_file_version)
+            {
+                return false;
+            }
+
+            interface.name = str();
+            for (auto n = count(); n > 0; n--)
+            {
+                interface.imports.emplace_back(str());
+            }
+            return valid_;
+        }
+
+        bool declarations(ModuleInterface &interface)
+        {
+            interface.declarations = std::make_unique<DeclarationsNode>(pos_);
+            auto &declarations = *interface.declarations;
+
+            for (auto n = count(); n > 0 && valid_; n--)
+            {
+                auto name = std::make_unique<IdentNode>(pos_, str());
+                declarations.add_type(std::move(name), type());
+            }
+
+            for (auto n = count(); n > 0 && valid_; n--)
+            {
+                auto name = std::make_unique<IdentNode>(pos_, str());
+                declarations.add_constant(std::move(name), std::make_unique<IntNode>(pos_, i64()));
+            }
+
+            for (auto n = count(); n > 0 && valid_; n--)
+            {
+                Symbol name = str();
+                std::unique_ptr<TypeNode> return_type = u8() ? type() : nullptr;
+
+                auto params = std::make_unique<parameters>();
+                for (auto sections = count(); sections > 0 && valid_; sections--)
+                {
+                    bool is_var = u8();
+                    auto idents = names();
+                    params->emplace_back(std::make_unique<fp_section_t>(is_var, std::move(idents), type()));
+                }
+
+                declarations.add_procedure(std::make_unique<ProcedureDeclarationNode>(pos_, std::make_unique<IdentNode>(pos_, name), std::move(params),
+                                                                                      std::make_unique<DeclarationsNode>(pos_), std::make_unique<IdentNode>(pos_, name),
+                                                                                      nullptr, std::move(return_type)));
+            }
+
+            return valid_ && data_.empty();
+        }
+    };
+
+}
+
+std::string SymbolFile::file_name(Symbol module)
+{
+    return module.str() + ".smb";
+}
+
+std::string SymbolFile::find(Symbol module, const std::vector<std::string> &directories)
+{
+    for (auto &directory : directories)
+    {
+        llvm::SmallString<128> path(directory);
+        llvm::sys::path::append(path, file_name(module));
+        if (llvm::sys::fs::exists(path))
+        {
+            return std::string(path);
+        }
+    }
+    return "";
+}
+
+bool SymbolFile::write(ModuleNode &module, const std::string &path, Logger &logger)
+{
+    std::string contents;
+    SymbolFileWriter writer(module.get_name().first->get_symbol(), logger);
+    if (!writer.describe(*module.get_declarations(), contents))
+    {
+        return false;
+    }
+    return write(path, contents, logger);
+}
+
+bool SymbolFile::write(const std::string &path, llvm::StringRef contents, Logger &logger)
+{
+    // importers compiled concurrently never see a partially written file
+    llvm::SmallString<128> model(path);
+    model.append("-%%%%%%%%.tmp");
+    int fd;
+    llvm::SmallString<128> temp_path;
+    if (auto ec = llvm::sys::fs::createUniqueFile(model, fd, temp_path))
+    {
+        logger.error(path, "Could not write symbol file: " + ec.message());
+        return false;
+    }
+
+    {
+        llvm::raw_fd_ostream file(fd, true);
+        file.write(contents.data(), contents.size());
+        file.close();
+        if (file.has_error())
+        {
+            logger.error(path, "Could not write symbol file: " + file.error().message());
+            file.clear_error();
+            llvm::sys::fs::remove(temp_path);
+            return false;
+        }
+    }
+
+    if (auto ec = llvm::sys::fs::rename(temp_path, path))
+    {
+        logger.error(path, "Could not write symbol file: " + ec.message());
+        llvm::sys::fs::remove(temp_path);
+        return false;
+    }
+    return true;
+}
+
+std::unique_ptr<ModuleInterface> SymbolFile::read(const std::string &path, FilePos pos, Logger &logger)
+{
+    // the file is mapped into memory rather than read, the declarations copy everything they keep
+    auto file = llvm::MemoryBuffer::getFile(path, false, false);
+    if (!file)
+    {
+        logger.error(pos, "Could not read symbol file '" + path + "': " + file.getError().message());
+        return nullptr;
+    }
+
+    auto interface = std::make_unique<ModuleInterface>();
+    SymbolFileReader reader((*file)->getBuffer(), pos);
+    if (!reader.header(*interface) || !reader.declarations(*interface))
+    {
+        logger.error(pos, "Symbol file '" + path + "' is damaged or was written by another version of the compiler, recompile the module.");
+        return nullptr;
+    }
+    return interface;
+}
+
+bool SymbolFile::read_imports(const std::string &path, std::vector<Symbol> &imports)
+{
+    auto file = llvm::MemoryBuffer::getFile(path, false, false);
+    if (!file)
+    {
+        return false;
+    }
+
+    ModuleInterface interface;
+    SymbolFileReader reader((*file)->getBuffer(), FilePos());
+    if (!reader.header(interface))
+    {
+        return false;
+    }
+    imports = std::move(interface.imports);
+    return true;
+}
@@ -0,0 +1,66 @@
+//
+// Created by M on 17.10.2026.
+//
+
+#ifndef OBERON0C_SYMBOLFILE_H
+#define OBERON0C_SYMBOLFILE_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <llvm/ADT/StringRef.h>
+
+#include "util/Logger.h"
+#include "util/Symbol.h"
+#include "util/datastructures/ast/ModuleNode.h"
+#include "util/datastructures/ast/declarations/DeclarationsNode.h"
+
+// Exported declarations of a module as described by its symbol file
+struct ModuleInterface
+{
+    Symbol name;
+    // modules whose types the interface refers to, their interfaces have to be declared first
+    std::vector<Symbol> imports;
+    // constants, types and procedure headings, declared names and type references are qualified ("M.x")
+    std::unique_ptr<DeclarationsNode> declarations;
+};
+
+/*
+ *  A symbol file ("<Module>.smb", written next to the source once a module has been checked) describes the exported
+ *  constants, types and procedure signatures of a module in a compact binary form, so that importers neither parse
+ *  nor check the module's source again. Reading a symbol file yields the declarations that the parser would have
+ *  produced for them, which are then entered into the importer's scope like any other declaration.
+ *
+ *  Layout (integers are little endian, strings are prefixed with their 32-bit length):
+ *      "OSYM" version:u32 module:string
+ *      imports:     u32 (module:string)*
+ *      types:       u32 (name:string type)*
+ *      constants:   u32 (name:string value:i64)*
+ *      procedures:  u32 (name:string has_result:u8 [type] sections:u32 (is_var:u8 u32 (param:string)* type)*)*
+ *  where a type is a tag byte followed by a type name, an array (size:i64 type), a record (u32 (u32 (field:string)*
+ *  type)*) or a pointer (type).
+ */
+class SymbolFile
+{
+
+public:
+    static std::string file_name(Symbol module);
+
+    // Returns the path of the module's symbol file in the first directory containing one, an empty string otherwise
+    static std::string find(Symbol module, const std::vector<std::string> &directories);
+
+    // Writes the exports of a checked module, returns false (after reporting why) if they cannot be described, e.g.
+    // because an exported procedure uses a type that is not exported
+    static bool write(ModuleNode &module, const std::string &path, Logger &logger);
+    // Writes the contents of a symbol file written before (e.g. kept in the compilation cache)
+    static bool write(const std::string &path, llvm::StringRef contents, Logger &logger);
+
+    // Returns nullptr (after reporting why) if the file cannot be read, the declarations are positioned at pos
+    static std::unique_ptr<ModuleInterface> read(const std::string &path, FilePos pos, Logger &logger);
+
+    // Only reads the modules an interface refers to, returns false if the file cannot be read
+    static bool read_imports(const std::string &path, std::vector<Symbol> &imports);
+};
+
+#endif //OBERON0C_SYMBOLFILE_H
@@ -0,0 +1,69 @@
+//
+// Created by M on 17.10.2026.
+//
+
+#include <cstdint>
+
+#include "Arena.h"
+#include "util/panic.h"
+
+static thread_local Arena *current_arena = nullptr;
+
+Arena::Arena() : cur_(nullptr), end_(nullptr), allocated_(0), previous_(current_arena)
+{
+    current_arena = this;
+}
+
+Arena::~Arena()
+{
+    current_arena = previous_;
+}
+
+std::byte *Arena::new_block(size_t size)
+{
+    blocks_.emplace_back(new std::byte[size]);
+    return blocks_.back().get();
+}
+
+void *Arena::allocate(size_t size, size_t alignment)
+{
+    auto aligned = reinterpret_cast<std::byte *>((reinterpret_cast<uintptr_t>(cur_) + alignment - 1) & ~(alignment - 1));
+
+    if (!cur_ || aligned + size > end_)
+    {
+        // Oversized requests get a block of their own so that the current block can still be filled up
+        if (size + alignment > block_size_ / 4)
+        {
+            auto block = new_block(size + alignment);
+            allocated_ += size;
+            return reinterpret_cast<std::byte *>((reinterpret_cast<uintptr_t>(block) + alignment - 1) & ~(alignment - 1));
+        }
+
+        cur_ = new_block(block_size_);
+        end_ = cur_ + block_size_;
+        aligned = reinterpret_cast<std::byte *>((reinterpret_cast<uintptr_t>(cur_) + alignment - 1) & ~(alignment - 1));
+    }
+
+    cur_ = aligned + size;
+    allocated_ += size;
+    return aligned;
+}
+
+size_t Arena::allocated() const
+{
+    return allocated_;
+}
+
+void *Arena::allocate_current(size_t size)
+{
+    if (!current_arena)
+    {
+        panic("No arena available for allocation.");
+    }
+    return current_arena->allocate(size);
+}
+
+Arena *Arena::current()
+{
+    return current_arena;
+}
@@ -0,0 +1,48 @@
+//
+// Bump allocator owning all AST nodes of one compilation
+// Created by M on 17.10.2026.
+//
+
+#ifndef OBERON0C_ARENA_H
+#define OBERON0C_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/*
+ *  Memory is handed out by bumping a pointer through large blocks and is only released when the arena itself is
+ *  destroyed. Constructing an arena makes it the current arena of the calling thread (until it is destroyed), which is
+ *  where AST nodes allocate themselves from. Destructors of nodes still run as usual, only the
+ *  underlying memory is reclaimed in one shot.
+ */
+class Arena
+{
+
+private:
+    static constexpr size_t block_size_ = 64 * 1024;
+
+    std::vector<std::unique_ptr<std::byte[]>> blocks_;
+    std::byte *cur_;
+    std::byte *end_;
+    size_t allocated_;
+    Arena *previous_;
+
+    std::byte *new_block(size_t size);
+
+public:
+    Arena();
+    ~Arena();
+
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    void *allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+    [[nodiscard]] size_t allocated() const;
+
+    // Allocates from the current arena of the calling thread (panics if there is none)
+    static void *allocate_current(size_t size);
+    static Arena *current();
+};
+
+#endif // OBERON0C_ARENA_H
@@ -0,0 +1,157 @@
+//
+// Created by M on 17.10.2026.
+//
+
+#include "CompilationCache.h"
+
+#include <llvm/ADT/StringExtras.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/Support/Endian.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/SHA1.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include "config.h"
+
+namespace {
+
+    // Layout of an entry: magic, number of outputs, then the size and bytes of each output (little endian)
+    const char entry_magic[4] = {'O', 'B', '0', 'C'};
+
+    // Fields are prefixed with their length so that different field boundaries never hash alike
+    void hash_field(llvm::SHA1 &sha, llvm::StringRef field)
+    {
+        uint8_t size[8];
+        llvm::support::endian::write64le(size, field.size());
+        sha.update(llvm::ArrayRef<uint8_t>(size));
+        sha.update(field);
+    }
+
+}
+
+std::string CompilationCache::entry_path(const std::string &key) const
+{
+    llvm::SmallString<128> path(directory_);
+    llvm::sys::path::append(path, key + ".entry");
+    return std::string(path);
+}
+
+std::string CompilationCache::key(const std::string &source_file, const std::string &configuration) const
+{
+    auto source = llvm::MemoryBuffer::getFile(source_file, false, false);
+    if (!source)
+    {
+        return "";
+    }
+
+    llvm::SHA1 sha;
+    hash_field(sha, PROJECT_NAME " " PROJECT_VERSION);
+    hash_field(sha, LLVM_VERSION_STRING);
+    hash_field(sha, configuration);
+    // the file name ends up in the output (module identifier, debug information)
+    hash_field(sha, source_file);
+    hash_field(sha, (*source)->getBuffer());
+    return llvm::toHex(sha.final(), true);
+}
+
+bool CompilationCache::lookup(const std::string &key, std::vector<llvm::SmallVector<char, 0>> &outputs)
+{
+    auto entry = llvm::MemoryBuffer::getFile(entry_path(key), false, false);
+    if (!entry)
+    {
+        misses_++;
+        return false;
+    }
+
+    // a damaged entry (e.g. truncated by a full disk) is treated like a missing one and replaced later
+    llvm::StringRef data = (*entry)->getBuffer();
+    if (data.size() < sizeof(entry_magic) + 4 || data.substr(0, sizeof(entry_magic)) != llvm::StringRef(entry_magic, sizeof(entry_magic)))
+    {
+        misses_++;
+        return false;
+    }
+    auto count = llvm::support::endian::read32le(data.data() + sizeof(entry_magic));
+    data = data.drop_front(sizeof(entry_magic) + 4);
+    if (count > data.size() / 8)
+    {
+        misses_++;
+        return false;
+    }
+
+    std::vector<llvm::SmallVector<char, 0>> entry_outputs(count);
+    for (auto &output : entry_outputs)
+    {
+        if (data.size() < 8)
+        {
+            misses_++;
+            return false;
+        }
+        auto size = llvm::support::endian::read64le(data.data());
+        data = data.drop_front(8);
+        if (data.size() < size)
+        {
+            misses_++;
+            return false;
+        }
+        output.append(data.begin(), data.begin() + size);
+        data = data.drop_front(size);
+    }
+
+    outputs = std::move(entry_outputs);
+    hits_++;
+    return true;
+}
+
+bool CompilationCache::store(const std::string &key, const std::vector<llvm::SmallVector<char, 0>> &outputs) const
+{
+    llvm::SmallString<128> model(directory_);
+    llvm::sys::path::append(model, key + "-%%%%%%%%.tmp");
+
+    int fd;
+    llvm::SmallString<128> temp_path;
+    if (llvm::sys::fs::createUniqueFile(model, fd, temp_path))
+    {
+        return false;
+    }
+
+    {
+        llvm::raw_fd_ostream file(fd, true);
+        uint8_t header[8];
+        file.write(entry_magic, sizeof(entry_magic));
+        llvm::support::endian::write32le(header, static_cast<uint32_t>(outputs.size()));
+        file.write(reinterpret_cast<const char *>(header), 4);
+        for (auto &output : outputs)
+        {
+            llvm::support::endian::write64le(header, output.size());
+            file.write(reinterpret_cast<const char *>(header), 8);
+            file.write(output.data(), output.size());
+        }
+        file.close();
+        if (file.has_error())
+        {
+            file.clear_error();
+            llvm::sys::fs::remove(temp_path);
+            return false;
+        }
+    }
+
+    // publishing the entry is atomic, concurrent writers of the same key write the same contents
+    if (llvm::sys::fs::rename(temp_path, entry_path(key)))
+    {
+        llvm::sys::fs::remove(temp_path);
+        return false;
+    }
+    return true;
+}
+
+unsigned int CompilationCache::hits() const
+{
+    return hits_;
+}
+
+unsigned int CompilationCache::misses() const
+{
+    return misses_;
+}
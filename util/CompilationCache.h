@@ -0,0 +1,48 @@
+//
+// Created by M on 17.10.2026.
+//
+
+#ifndef OBERON0C_COMPILATIONCACHE_H
+#define OBERON0C_COMPILATIONCACHE_H
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include <llvm/ADT/SmallVector.h>
+
+/*
+ *  Content-addressed cache of compiler outputs shared by all compiler processes using the same directory. An entry is
+ *  keyed on the SHA-1 of the source bytes, the compiler and LLVM versions and a description of everything else that
+ *  influences the output (options, target), and holds the outputs of one compilation (e.g. the object files of all
+ *  partitions of a module). Entries are written to a temporary file that is renamed into place, so readers never see
+ *  a partially written entry and concurrent writers of the same entry simply replace each other's identical results.
+ *  All members are thread-safe.
+ */
+class CompilationCache
+{
+
+private:
+    std::string directory_;
+    std::atomic<unsigned int> hits_ = 0, misses_ = 0;
+
+    [[nodiscard]] std::string entry_path(const std::string &key) const;
+
+public:
+    // The directory has to exist
+    explicit CompilationCache(std::string directory) : directory_(std::move(directory)) {};
+
+    // Returns an empty key if the source file cannot be read
+    [[nodiscard]] std::string key(const std::string &source_file, const std::string &configuration) const;
+
+    // Returns true (and the outputs of the compilation) if the entry exists, counts a hit or a miss
+    bool lookup(const std::string &key, std::vector<llvm::SmallVector<char, 0>> &outputs);
+
+    // Returns false if the entry could not be written, the cache stays consistent in any case
+    bool store(const std::string &key, const std::vector<llvm::SmallVector<char, 0>> &outputs) const;
+
+    [[nodiscard]] unsigned int hits() const;
+    [[nodiscard]] unsigned int misses() const;
+};
+
+#endif //OBERON0C_COMPILATIONCACHE_H
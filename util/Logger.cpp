@@ -9,6 +9,7 @@
 #include <iostream>
 #include <string>
 #include "config.h"
+#include "SourceManager.h"
 
 using std::ostream;
 using std::string;
@@ -52,11 +53,11 @@ void Logger::log(const LogLevel level, const string &msg, bool silent) {
 }
 
 void Logger::error(const FilePos &pos, const string &msg, bool silent) {
-
-    if(pos.fileName.empty()){
-        log(LogLevel::ERROR, PROJECT_NAME, pos.lineNo, pos.charNo, msg, silent);
+    auto resolved = SourceManager::resolve(pos);
+    if(resolved.fileName.empty()){
+        log(LogLevel::ERROR, PROJECT_NAME, resolved.lineNo, resolved.charNo, msg, silent);
     }else{
-        log(LogLevel::ERROR, pos.fileName, pos.lineNo, pos.charNo, msg, silent);
+        log(LogLevel::ERROR, resolved.fileName, resolved.lineNo, resolved.charNo, msg, silent);
     }
 }
 
@@ -70,7 +71,8 @@ void Logger::error(const string &fileName, const string &msg, bool silent) {
 }
 
 void Logger::warning(const FilePos &pos, const string &msg, bool silent) {
-    log(LogLevel::WARNING, pos.fileName, pos.lineNo, pos.charNo, msg, silent);
+    auto resolved = SourceManager::resolve(pos);
+    log(LogLevel::WARNING, resolved.fileName, resolved.lineNo, resolved.charNo, msg, silent);
 }
 
 void Logger::warning(const string &fileName, const string &msg, bool silent) {
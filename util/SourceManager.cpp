@@ -0,0 +1,184 @@
+//
+// Created by M on 17.10.2026.
+//
+
+#include "SourceManager.h"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+    struct SourceFile
+    {
+        std::string name;
+        std::unique_ptr<llvm::MemoryBuffer> buffer;
+        uint32_t base; // offset of the file's first character in the global offset space
+        unsigned int users = 0;
+        std::once_flag lines_computed;
+        std::vector<uint32_t> line_starts;
+    };
+
+    struct FileRegistry
+    {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<SourceFile>> files;
+        std::unordered_map<std::string, FileId> loaded; // files in use by name
+        uint32_t next_base = 1;
+
+        FileRegistry()
+        {
+            // file 0 represents "no file" and owns offset 0
+            files.push_back(std::make_unique<SourceFile>());
+            files.back()->base = 0;
+        }
+    };
+
+    FileRegistry &registry()
+    {
+        static FileRegistry registry;
+        return registry;
+    }
+
+    SourceFile &file(FileId id)
+    {
+        auto &files = registry();
+        std::lock_guard<std::mutex> lock(files.mutex);
+        return id < files.files.size() ? *files.files[id] : *files.files.front();
+    }
+
+}
+
+FileId SourceManager::load_file(const std::string &file_name, Logger &logger)
+{
+    auto &files = registry();
+    {
+        std::lock_guard<std::mutex> lock(files.mutex);
+        auto loaded = files.loaded.find(file_name);
+        if (loaded != files.loaded.end())
+        {
+            files.files[loaded->second]->users++;
+            return loaded->second;
+        }
+    }
+
+    auto buffer = llvm::MemoryBuffer::getFile(file_name, false, false);
+    if (!buffer)
+    {
+        logger.error("", "cannot open file: " + file_name + ".");
+        return 0;
+    }
+
+    auto source = std::make_unique<SourceFile>();
+    source->name = file_name;
+    source->buffer = std::move(buffer.get());
+    source->users = 1;
+
+    std::lock_guard<std::mutex> lock(files.mutex);
+    // the file may have been loaded concurrently
+    auto loaded = files.loaded.find(file_name);
+    if (loaded != files.loaded.end())
+    {
+        files.files[loaded->second]->users++;
+        return loaded->second;
+    }
+
+    // positions within a file range from 1 (first character) up to size + 1 (end of file)
+    auto size = source->buffer->getBufferSize();
+    if (files.next_base + size + 2 > UINT32_MAX)
+    {
+        logger.error(file_name, "Total size of source files exceeds the supported maximum.");
+        return 0;
+    }
+    source->base = files.next_base;
+    files.next_base += static_cast<uint32_t>(size) + 2;
+
+    files.files.push_back(std::move(source));
+    auto id = static_cast<FileId>(files.files.size() - 1);
+    files.loaded.emplace(file_name, id);
+    return id;
+}
+
+void SourceManager::release(FileId id)
+{
+    if (id == 0)
+    {
+        return;
+    }
+
+    auto &files = registry();
+    std::lock_guard<std::mutex> lock(files.mutex);
+    auto &source = *files.files[id];
+    if (--source.users == 0)
+    {
+        // the offsets of the file stay reserved, a later load_file of the same name registers a new file
+        files.loaded.erase(source.name);
+        source.buffer.reset();
+        source.line_starts = std::vector<uint32_t>();
+    }
+}
+
+const std::string &SourceManager::file_name(FileId id)
+{
+    return file(id).name;
+}
+
+const llvm::MemoryBuffer &SourceManager::buffer(FileId id)
+{
+    return *file(id).buffer;
+}
+
+FilePos SourceManager::position(FileId id, uint32_t index)
+{
+    return {file(id).base + index + 1};
+}
+
+FileId SourceManager::file_of(FilePos pos)
+{
+    if (pos.offset == 0)
+    {
+        return 0;
+    }
+
+    auto &files = registry();
+    std::lock_guard<std::mutex> lock(files.mutex);
+    // files are ordered by their base offset
+    auto it = std::upper_bound(files.files.begin() + 1, files.files.end(), pos.offset,
+                               [](uint32_t offset, const std::unique_ptr<SourceFile> &f) { return offset < f->base; });
+    return static_cast<FileId>(std::distance(files.files.begin(), it) - 1);
+}
+
+uint32_t SourceManager::index_of(FilePos pos)
+{
+    return pos.offset - file(file_of(pos)).base - 1;
+}
+
+ResolvedPos SourceManager::resolve(FilePos pos)
+{
+    auto id = file_of(pos);
+    auto &source = file(id);
+    if (id == 0 || !source.buffer)
+    {
+        return {source.name, -1, -1};
+    }
+
+    std::call_once(source.lines_computed, [&source]() {
+        source.line_starts.push_back(0);
+        auto start = source.buffer->getBufferStart();
+        auto size = source.buffer->getBufferSize();
+        for (size_t i = 0; i < size; i++)
+        {
+            if (start[i] == '\n')
+            {
+                source.line_starts.push_back(static_cast<uint32_t>(i + 1));
+            }
+        }
+    });
+
+    auto index = pos.offset - source.base - 1;
+    auto line = std::upper_bound(source.line_starts.begin(), source.line_starts.end(), index) - 1;
+    return {source.name, static_cast<int>(line - source.line_starts.begin()) + 1, static_cast<int>(index - *line) + 1};
+}
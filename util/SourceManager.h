@@ -0,0 +1,47 @@
+//
+// Owns all source files taking part in a compilation and resolves source positions
+// Created by M on 17.10.2026.
+//
+
+#ifndef OBERON0C_SOURCEMANAGER_H
+#define OBERON0C_SOURCEMANAGER_H
+
+#include <string>
+#include <llvm/Support/MemoryBuffer.h>
+#include "global.h"
+#include "Logger.h"
+
+// Human-readable form of a FilePos (only computed when needed, e.g. for diagnostics)
+struct ResolvedPos {
+    const std::string &fileName;
+    int lineNo, charNo;
+};
+
+/*
+ *  All loaded files are laid out one after another in a single 32-bit offset space, a FilePos is simply an offset into
+ *  this space. Line and column numbers are not tracked during scanning; instead, each file's line start table is built
+ *  the first time a position within that file is resolved. Offset 0 is reserved for "no position", file id 0 for
+ *  "no file". All members are thread-safe.
+ */
+class SourceManager
+{
+
+public:
+    // Loads the file into memory (memory-mapping large files), returns 0 and reports an error if it cannot be loaded.
+    // A file that is already loaded is shared, each load_file has to be matched by a release.
+    static FileId load_file(const std::string &file_name, Logger &logger);
+    // Frees the file's memory once it is no longer used, its positions can no longer be resolved afterwards
+    static void release(FileId file);
+
+    static const std::string &file_name(FileId file);
+    static const llvm::MemoryBuffer &buffer(FileId file);
+
+    // Converts between positions and (file, index of the character within that file)
+    static FilePos position(FileId file, uint32_t index);
+    static FileId file_of(FilePos pos);
+    static uint32_t index_of(FilePos pos);
+
+    static ResolvedPos resolve(FilePos pos);
+};
+
+#endif // OBERON0C_SOURCEMANAGER_H
@@ -0,0 +1,97 @@
+//
+// Created by M on 17.10.2026.
+//
+
+#include "Symbol.h"
+
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+
+    // Transparent hashing allows looking up string_views without allocating a temporary string
+    struct StringHash
+    {
+        using is_transparent = void;
+        size_t operator()(std::string_view str) const { return std::hash<std::string_view>()(str); }
+    };
+
+    // Node-based container, i.e. the address of an interned string never changes after insertion
+    struct SymbolPool
+    {
+        std::mutex mutex;
+        std::unordered_set<std::string, StringHash, std::equal_to<>> strings;
+    };
+
+    SymbolPool &pool()
+    {
+        static SymbolPool pool;
+        return pool;
+    }
+
+}
+
+const std::string *Symbol::intern(std::string_view str)
+{
+    // the keys refer to the pooled strings, which never move
+    thread_local std::unordered_map<std::string_view, const std::string *> cache;
+    auto cached = cache.find(str);
+    if (cached != cache.end())
+    {
+        return cached->second;
+    }
+
+    auto &symbols = pool();
+    std::lock_guard<std::mutex> lock(symbols.mutex);
+    auto it = symbols.strings.find(str);
+    if (it == symbols.strings.end())
+    {
+        it = symbols.strings.emplace(str).first;
+    }
+    cache.emplace(*it, &*it);
+    return &*it;
+}
+
+Symbol::Symbol()
+{
+    static const std::string *empty = intern("");
+    str_ = empty;
+}
+
+Symbol::Symbol(std::string_view str) : str_(intern(str)) {}
+
+Symbol Symbol::integer_type()
+{
+    static const Symbol symbol("INTEGER");
+    return symbol;
+}
+
+Symbol Symbol::real_type()
+{
+    static const Symbol symbol("REAL");
+    return symbol;
+}
+
+Symbol Symbol::boolean_type()
+{
+    static const Symbol symbol("BOOLEAN");
+    return symbol;
+}
+
+Symbol Symbol::char_type()
+{
+    static const Symbol symbol("CHAR");
+    return symbol;
+}
+
+Symbol Symbol::string_type()
+{
+    static const Symbol symbol("STRING");
+    return symbol;
+}
+
+std::ostream &operator<<(std::ostream &stream, const Symbol &symbol)
+{
+    return stream << symbol.str();
+}
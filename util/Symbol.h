@@ -0,0 +1,60 @@
+//
+// Interned identifier shared by the scanner, the AST and all symbol tables
+// Created by M on 17.10.2026.
+//
+
+#ifndef OBERON0C_SYMBOL_H
+#define OBERON0C_SYMBOL_H
+
+#include <string>
+#include <string_view>
+#include <functional>
+#include <ostream>
+
+/*
+ *  A Symbol is a handle to a string stored exactly once in a global pool.
+ *  Two symbols are equal iff they refer to the same pool entry, hence comparing and hashing symbols boils down to
+ *  comparing and hashing a pointer. Pool entries are never freed, so handles stay valid for the whole compilation.
+ *  Each thread keeps a cache of the strings it has interned, only strings new to a thread are looked up in the pool.
+ */
+class Symbol
+{
+
+private:
+    const std::string *str_;
+
+    static const std::string *intern(std::string_view str);
+
+public:
+    Symbol();
+    Symbol(std::string_view str);
+    Symbol(const std::string &str) : Symbol(std::string_view(str)) {};
+    Symbol(const char *str) : Symbol(std::string_view(str)) {};
+
+    [[nodiscard]] const std::string &str() const { return *str_; };
+    operator const std::string &() const { return *str_; };
+
+    [[nodiscard]] bool empty() const { return str_->empty(); };
+
+    bool operator==(const Symbol &other) const { return str_ == other.str_; };
+    bool operator!=(const Symbol &other) const { return str_ != other.str_; };
+
+    [[nodiscard]] size_t hash() const { return std::hash<const std::string *>()(str_); };
+
+    // symbols of the predeclared types, interned once
+    static Symbol integer_type();
+    static Symbol real_type();
+    static Symbol boolean_type();
+    static Symbol char_type();
+    static Symbol string_type();
+
+    friend std::ostream &operator<<(std::ostream &stream, const Symbol &symbol);
+};
+
+template <>
+struct std::hash<Symbol>
+{
+    size_t operator()(const Symbol &symbol) const noexcept { return symbol.hash(); }
+};
+
+#endif // OBERON0C_SYMBOL_H
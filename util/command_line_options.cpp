@@ -13,11 +13,25 @@ std::shared_ptr<po::options_description> init_options(){
             ("help,h", "Displays this information.")
             ("debug,d","Enables debug prints.")
             ("quiet,q","Disables all outputs.")
-            ("filetype,f", po::value<std::string>()->value_name("<type>"),"Sets output filetype. Default is \'.ll\'. [asm,obj,ll]")
+            ("filetype,f", po::value<std::string>()->value_name("<type>"),"Sets output filetype. Default is \'.ll\'. [asm,obj,ll,bc]")
             ("print,p","Prints compiled program to console.")
-            // custom triplet
-            // custom output filename
-            // (run?)
+            ("optimize,O", po::value<int>()->value_name("<level>"),"Sets optimization level. Default is 0. [0,1,2,3]")
+            ("target", po::value<std::string>()->value_name("<triple>"),"Sets target triple. Default is the host's default triple. ['native' for the host process]")
+            ("mcpu", po::value<std::string>()->value_name("<cpu>"),"Sets target CPU. Default is 'generic'. ['native' for the host CPU]")
+            ("mattr", po::value<std::string>()->value_name("<features>"),"Sets target features, e.g. '+avx2,-sse4a'. ['native' for the host features]")
+            ("threads,t", po::value<unsigned int>()->value_name("<n>"),"Sets number of files compiled in parallel. Default is the number of hardware threads.")
+            ("jobs,j", po::value<unsigned int>()->value_name("<n>"),"Splits large modules and generates their object code on <n> threads. The output does not depend on <n>.")
+            ("import-path,I", po::value<std::vector<std::string>>()->value_name("<dir>"),"Searches <dir> for symbol files of imported modules after the directory of the importing file.")
+            ("cache-dir", po::value<std::string>()->value_name("<dir>"),"Reuses the outputs of earlier compilations of unchanged files stored in <dir>.")
+            ("cache-stats","Reports the compilation cache's hits and misses.")
+            ("timing","Reports the time spent in each compilation phase and the time until the first IR is available.")
+            ("bounds-check","Checks array indices at runtime, except where they are proven to be in bounds.")
+            ("debug-info,g","Generates debug information for source-level debugging and profiling.")
+            ("profile-generate","Instruments the program to write an execution profile (default.profraw, see LLVM_PROFILE_FILE) when it exits.")
+            ("profile-use", po::value<std::string>()->value_name("<file>"),"Optimizes the program using a profile merged with 'llvm-profdata merge'. Requires -O1 or higher.")
+            ("run,r","Compiles the program in-process and runs it, returning its exit code instead of writing an output file.")
+            ("whole-program","Links the modules into one before optimizing them, so that procedures are inlined across modules. Requires -o.")
+            ("output,o", po::value<std::string>()->value_name("<file>"),"Links the program with the Oberon runtime into the executable <file>.")
             ;
 
     return options;
@@ -28,7 +42,7 @@ std::shared_ptr<po::variables_map> create_value_map(po::options_description* opt
     auto vm = std::make_shared<po::variables_map>();
 
     auto input_option = po::options_description("Input");
-    input_option.add_options()("input",po::value<std::string>());
+    input_option.add_options()("input",po::value<std::vector<std::string>>());
 
     auto all_options = po::options_description();
     all_options.add(*options).add(input_option);
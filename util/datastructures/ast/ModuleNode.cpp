@@ -17,7 +17,19 @@ void ModuleNode::accept(NodeVisitor &visitor)
 }
 
 string ModuleNode::to_string() const {
-    string s = "MODULE " + module_name_begin_->to_string() + ";\n" + declarations_->to_string();
+    string s = "MODULE " + module_name_begin_->to_string() + ";\n";
+
+    if (!imports_.empty())
+    {
+        s += "IMPORT ";
+        for (size_t i = 0; i < imports_.size(); i++)
+        {
+            s += (i > 0 ? ", " : "") + imports_[i]->to_string();
+        }
+        s += ";\n";
+    }
+
+    s += declarations_->to_string();
 
     if (statements_)
     {
@@ -40,4 +52,55 @@ DeclarationsNode *ModuleNode::get_declarations() {
 
 StatementSequenceNode *ModuleNode::get_statements() {
     return statements_.get();
-}
\ No newline at end of file
+}
+
+void ModuleNode::add_import(std::unique_ptr<IdentNode> module) {
+    imports_.emplace_back(std::move(module));
+}
+
+std::vector<IdentNode *> ModuleNode::get_imports() {
+    std::vector<IdentNode *> imports;
+    for (auto &module : imports_)
+    {
+        imports.push_back(module.get());
+    }
+    return imports;
+}
+
+void ModuleNode::add_interface(Symbol module, std::unique_ptr<DeclarationsNode> declarations) {
+    interfaces_.emplace_back(module, std::move(declarations));
+}
+
+std::vector<std::pair<Symbol, DeclarationsNode *>> ModuleNode::get_interfaces() {
+    std::vector<std::pair<Symbol, DeclarationsNode *>> interfaces;
+    for (auto &[module, declarations] : interfaces_)
+    {
+        interfaces.emplace_back(module, declarations.get());
+    }
+    return interfaces;
+}
+
+bool ModuleNode::has_exports() {
+    for (auto &[ident, expr] : declarations_->get_constants())
+    {
+        if (ident->is_exported())
+        {
+            return true;
+        }
+    }
+    for (auto &[ident, type] : declarations_->get_typenames())
+    {
+        if (ident->is_exported())
+        {
+            return true;
+        }
+    }
+    for (auto procedure : declarations_->get_procedures())
+    {
+        if (procedure->get_names().first->is_exported())
+        {
+            return true;
+        }
+    }
+    return false;
+}
@@ -5,7 +5,9 @@
 #ifndef OBERON0C_MODULENODE_H
 #define OBERON0C_MODULENODE_H
 
+#include <vector>
 #include "Node.h"
+#include "util/Symbol.h"
 
 class IdentNode;
 class DeclarationsNode;
@@ -19,6 +21,11 @@ class ModuleNode : public Node {
     std::unique_ptr<StatementSequenceNode> statements_;
     std::unique_ptr<IdentNode> module_name_end_;
 
+    std::vector<std::unique_ptr<IdentNode>> imports_;
+    // exported declarations of the imported modules and of the modules their interfaces refer to (in the order they
+    // have to be declared), identifiers are qualified with the module name
+    std::vector<std::pair<Symbol, std::unique_ptr<DeclarationsNode>>> interfaces_;
+
     public:
 
     ModuleNode(FilePos pos, std::unique_ptr<IdentNode> name_start, std::unique_ptr<DeclarationsNode> declarations, std::unique_ptr<StatementSequenceNode> statements, std::unique_ptr<IdentNode> name_end);
@@ -31,6 +38,14 @@ class ModuleNode : public Node {
     DeclarationsNode* get_declarations();
     StatementSequenceNode* get_statements();
 
+    void add_import(std::unique_ptr<IdentNode> module);
+    std::vector<IdentNode*> get_imports();
+    void add_interface(Symbol module, std::unique_ptr<DeclarationsNode> declarations);
+    std::vector<std::pair<Symbol, DeclarationsNode*>> get_interfaces();
+
+    // modules exporting declarations are libraries, all other modules are programs
+    bool has_exports();
+
 };
 
 
@@ -5,9 +5,14 @@
  */
 
 #include "Node.h"
+#include "util/Arena.h"
 
 Node::~Node() = default;
 
+void *Node::operator new(size_t size) {
+    return Arena::allocate_current(size);
+}
+
 NodeType Node::getNodeType() const {
     return nodeType_;
 }
@@ -56,6 +56,10 @@ public:
     explicit Node(const NodeType nodeType, FilePos pos) : nodeType_(nodeType), pos_(std::move(pos)) { };
     virtual ~Node();
 
+    // nodes live in the arena of the current compilation and are released all at once together with it
+    static void *operator new(size_t size);
+    static void operator delete(void *) { };
+
     [[nodiscard]] NodeType getNodeType() const;
     [[nodiscard]] FilePos pos() const;
 
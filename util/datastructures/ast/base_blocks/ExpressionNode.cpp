@@ -179,6 +179,11 @@ ExpressionNode *UnaryExpressionNode::get_expr()
     return expr_.get();
 }
 
+void UnaryExpressionNode::set_expr(std::unique_ptr<ExpressionNode> expr)
+{
+    expr_ = std::move(expr);
+}
+
 SourceOperator UnaryExpressionNode::get_op()
 {
     return op_;
@@ -221,6 +226,16 @@ ExpressionNode *BinaryExpressionNode::get_lhs()
     return lhs_.get();
 }
 
+void BinaryExpressionNode::set_rhs(std::unique_ptr<ExpressionNode> rhs)
+{
+    rhs_ = std::move(rhs);
+}
+
+void BinaryExpressionNode::set_lhs(std::unique_ptr<ExpressionNode> lhs)
+{
+    lhs_ = std::move(lhs);
+}
+
 SourceOperator BinaryExpressionNode::get_op()
 {
     return op_;
@@ -55,6 +55,7 @@ class UnaryExpressionNode : public ExpressionNode{
     void accept(NodeVisitor &visitor) override;
     [[nodiscard]] string to_string() const override;
     ExpressionNode* get_expr();
+    void set_expr(std::unique_ptr<ExpressionNode> expr);
     SourceOperator get_op();
 
 };
@@ -71,6 +72,8 @@ class BinaryExpressionNode : public ExpressionNode{
     BinaryExpressionNode* insert_rightmost(SourceOperator op, std::unique_ptr<ExpressionNode> new_rhs);
     ExpressionNode* get_rhs();
     ExpressionNode* get_lhs();
+    void set_rhs(std::unique_ptr<ExpressionNode> rhs);
+    void set_lhs(std::unique_ptr<ExpressionNode> lhs);
     SourceOperator get_op();
     void accept(NodeVisitor &visitor) override;
     [[nodiscard]] string to_string() const override;
@@ -10,10 +10,22 @@ void IdentNode::accept(NodeVisitor &visitor)
     visitor.visit(*this);
 }
 
-string IdentNode::get_value() {
+const string &IdentNode::get_value() const {
+    return name_.str();
+}
+
+Symbol IdentNode::get_symbol() const {
     return name_;
 }
 
+void IdentNode::set_exported() {
+    exported_ = true;
+}
+
+bool IdentNode::is_exported() const {
+    return exported_;
+}
+
 string IdentNode::to_string() const {
     return name_;
 }
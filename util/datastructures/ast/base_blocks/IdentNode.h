@@ -13,17 +13,23 @@ class IdentNode : public TypeNode
 {
 
 private:
-    const string name_;
+    const Symbol name_;
     std::shared_ptr<TypeInfo> formal_type_;
     std::shared_ptr<TypeInfo> actual_type_;
+    bool exported_ = false;
 
 public:
-    IdentNode(FilePos pos, const string name) : TypeNode(NodeType::ident, pos), name_(name) {};
+    IdentNode(FilePos pos, Symbol name) : TypeNode(NodeType::ident, pos), name_(name) {};
 
     void accept(NodeVisitor &visitor) override;
     string to_string() const override;
 
-    string get_value();
+    const string &get_value() const;
+    Symbol get_symbol() const;
+
+    // set for identifiers declared with an export mark ("*")
+    void set_exported();
+    bool is_exported() const;
 
 };
 
@@ -48,6 +48,12 @@ void SelectorNode::add_index(std::unique_ptr<ExpressionNode> expr)
     selectors_raw.emplace_back(true, nullptr,std::get<2>(selectors.back()).get());
 }
 
+void SelectorNode::set_index(size_t position, std::unique_ptr<ExpressionNode> expr)
+{
+    std::get<2>(selectors_raw.at(position)) = expr.get();
+    std::get<2>(selectors.at(position)) = std::move(expr);
+}
+
 SelectorNode::SelectorNode(FilePos pos) : Node(NodeType::selector, pos)
 {
 }
@@ -26,6 +26,8 @@ class SelectorNode : public Node {
 
         void add_field(std::unique_ptr<IdentNode> ident);
         void add_index(std::unique_ptr<ExpressionNode> expr);
+        // replaces the expression of the position-th selector, which has to be an array index
+        void set_index(size_t position, std::unique_ptr<ExpressionNode> expr);
 
         void accept(NodeVisitor &visitor) override;
         string to_string() const override;
@@ -78,10 +78,10 @@ std::vector<raw_field> RecordTypeNode::get_fields() {
     return fields;
 }
 
-void RecordTypeNode::insert_field_types(std::map<string, std::shared_ptr<TypeInfo>>& field_types) {
-    field_typeinfos_ = field_types;
+void RecordTypeNode::set_record_type(std::shared_ptr<TypeInfo> record_type) {
+    record_type_ = std::move(record_type);
 }
 
-std::map<string, std::shared_ptr<TypeInfo>> *RecordTypeNode::get_field_types() {
-    return &field_typeinfos_;
+const RecordTypeInfo *RecordTypeNode::get_layout() const {
+    return record_type_ ? &std::get<RecordTypeInfo>(record_type_->extended_info.value()) : nullptr;
 }
\ No newline at end of file
@@ -26,7 +26,7 @@ class RecordTypeNode : public TypeNode
 private:
     std::vector<std::unique_ptr<field>> fields_;
     std::map<string, TypeNode *> field_typenodes_;
-    std::map<string, std::shared_ptr<TypeInfo>> field_typeinfos_;
+    std::shared_ptr<TypeInfo> record_type_;
 
 public:
     RecordTypeNode(FilePos pos, std::unique_ptr<field> first_field);
@@ -37,9 +37,9 @@ public:
     string to_string() const override;
 
     std::vector<raw_field> get_fields();
-    std::map<string, std::shared_ptr<TypeInfo>> *get_field_types();
+    [[nodiscard]] const RecordTypeInfo *get_layout() const;
 
-    void insert_field_types(std::map<string, std::shared_ptr<TypeInfo>> &field_types);
+    void set_record_type(std::shared_ptr<TypeInfo> record_type);
 };
 
 #endif // OBERON0C_RECORDTYPENODE_H
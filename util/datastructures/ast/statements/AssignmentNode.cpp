@@ -40,4 +40,8 @@ SelectorNode *AssignmentNode::get_selector() {
 
 ExpressionNode *AssignmentNode::get_expr() {
     return expr_.get();
+}
+
+void AssignmentNode::set_expr(std::unique_ptr<ExpressionNode> expr) {
+    expr_ = std::move(expr);
 }
\ No newline at end of file
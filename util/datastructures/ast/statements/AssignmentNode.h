@@ -27,6 +27,7 @@ class AssignmentNode : public StatementNode{
         IdentNode* get_variable();
         SelectorNode* get_selector();
         ExpressionNode* get_expr();
+        void set_expr(std::unique_ptr<ExpressionNode> expr);
 
 };
 
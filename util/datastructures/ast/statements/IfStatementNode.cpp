@@ -47,6 +47,10 @@ ExpressionNode *IfStatementNode::get_condition() {
     return condition_.get();
 }
 
+void IfStatementNode::set_condition(std::unique_ptr<ExpressionNode> condition) {
+    condition_ = std::move(condition);
+}
+
 StatementSequenceNode *IfStatementNode::get_then() {
     return then_statements_.get();
 }
@@ -32,6 +32,7 @@ class IfStatementNode : public StatementNode {
         string to_string() const override;
 
         ExpressionNode* get_condition();
+        void set_condition(std::unique_ptr<ExpressionNode> condition);
         StatementSequenceNode* get_then();
         std::vector<ElseIfPair>* get_else_ifs();
         StatementSequenceNode* get_else();
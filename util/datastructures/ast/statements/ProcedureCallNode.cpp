@@ -53,11 +53,11 @@ std::vector<std::unique_ptr<ExpressionNode>> *ProcedureCallNode::get_parameters(
     return parameters_.get();
 }
 
-void ProcedureCallNode::set_name(const string &name) {
+void ProcedureCallNode::set_name(Symbol name) {
     procedure_name = name;
 }
 
-string ProcedureCallNode::get_name() {
+Symbol ProcedureCallNode::get_name() {
     return procedure_name;
 }
 
@@ -8,6 +8,7 @@
 #include <memory>
 #include <vector>
 #include "StatementNode.h"
+#include "util/Symbol.h"
 #include "util/datastructures/ast/declarations/ProcedureDeclarationNode.h"
 
 class IdentNode;
@@ -19,7 +20,7 @@ class ProcedureCallNode : public StatementNode {
     private:
         std::unique_ptr<IdentNode> ident_;
         std::unique_ptr<SelectorNode> selector_;
-        string procedure_name;
+        Symbol procedure_name;
 
         ProcedureDeclarationNode* procedure_declaration_ = nullptr;
 
@@ -34,8 +35,8 @@ class ProcedureCallNode : public StatementNode {
         IdentNode* get_ident();
         SelectorNode* get_selector();
 
-        void set_name(const string&);
-        string get_name();
+        void set_name(Symbol);
+        Symbol get_name();
 
         std::vector<std::unique_ptr<ExpressionNode>>* get_parameters();
 
@@ -23,6 +23,10 @@ ExpressionNode *RepeatStatementNode::get_expr() {
     return condition_.get();
 }
 
+void RepeatStatementNode::set_expr(std::unique_ptr<ExpressionNode> condition) {
+    condition_ = std::move(condition);
+}
+
 StatementSequenceNode *RepeatStatementNode::get_statements() {
     return statements_.get();
 }
@@ -23,6 +23,7 @@ class RepeatStatementNode : public StatementNode {
         void accept(NodeVisitor &visitor) override;
 
         ExpressionNode* get_expr();
+        void set_expr(std::unique_ptr<ExpressionNode> condition);
         StatementSequenceNode* get_statements();
 };
 
@@ -24,4 +24,8 @@ void ReturnStatementNode::accept(NodeVisitor &visitor) {
 
 ExpressionNode *ReturnStatementNode::get_value() {
     return value_.get();
+}
+
+void ReturnStatementNode::set_value(std::unique_ptr<ExpressionNode> value) {
+    value_ = std::move(value);
 }
\ No newline at end of file
@@ -19,6 +19,7 @@ class ReturnStatementNode : public StatementNode{
         void accept(NodeVisitor &visitor) override;
 
         ExpressionNode* get_value();
+        void set_value(std::unique_ptr<ExpressionNode> value);
 };
 
 
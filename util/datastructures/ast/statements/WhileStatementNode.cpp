@@ -24,6 +24,10 @@ ExpressionNode *WhileStatementNode::get_expr() {
     return condition_.get();
 }
 
+void WhileStatementNode::set_expr(std::unique_ptr<ExpressionNode> condition) {
+    condition_ = std::move(condition);
+}
+
 StatementSequenceNode *WhileStatementNode::get_statements() {
     return statements_.get();
 }
\ No newline at end of file
@@ -24,6 +24,7 @@ class WhileStatementNode : public StatementNode {
         string to_string() const override;
 
         ExpressionNode* get_expr();
+        void set_expr(std::unique_ptr<ExpressionNode> condition);
         StatementSequenceNode* get_statements();
 };
 
@@ -1,33 +1,35 @@
 #include "LLVMValueTable.h"
 
-void LLVMValueTable::insert(std::string name, llvm::Value *var, llvm::Type* type, bool is_pointer)
+void LLVMValueTable::insert(Symbol name, llvm::Value *var, llvm::Type* type, bool is_pointer)
 {
     variables_.back()[name] = {var, type,is_pointer};
 }
 
-void LLVMValueTable::insert_type(std::string name, llvm::Type *type) {
+void LLVMValueTable::insert_type(Symbol name, llvm::Type *type) {
     types_.back()[name] = type;
 }
 
-VariableInfo* LLVMValueTable::lookup(std::string name)
+VariableInfo* LLVMValueTable::lookup(Symbol name)
 {
     for (auto it = variables_.rbegin(); it != variables_.rend(); ++it)
     {
-        if (it->find(name) != it->end())
+        auto var = it->find(name);
+        if (var != it->end())
         {
-            return &(*it)[name];
+            return &var->second;
         }
     }
 
     return nullptr;
 }
 
-llvm::Type *LLVMValueTable::lookup_type(std::string name) {
+llvm::Type *LLVMValueTable::lookup_type(Symbol name) {
     for (auto it = types_.rbegin(); it != types_.rend(); ++it)
     {
-        if (it->find(name) != it->end())
+        auto type = it->find(name);
+        if (type != it->end())
         {
-            return (*it)[name];
+            return type->second;
         }
     }
 
@@ -36,8 +38,8 @@ llvm::Type *LLVMValueTable::lookup_type(std::string name) {
 
 void LLVMValueTable::beginScope()
 {
-    variables_.push_back(std::unordered_map<std::string, VariableInfo>());
-    types_.push_back(std::unordered_map<std::string,llvm::Type*>());
+    variables_.push_back(std::unordered_map<Symbol, VariableInfo>());
+    types_.push_back(std::unordered_map<Symbol,llvm::Type*>());
 }
 
 void LLVMValueTable::endScope()
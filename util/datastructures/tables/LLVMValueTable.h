@@ -3,6 +3,7 @@
 #include <utility>
 #include <llvm/IR/Instructions.h>
 #include <llvm/IR/Type.h>
+#include "util/Symbol.h"
 
 #ifndef OBERON0_VARIABLETABLE_H
 #define OBERON0_VARIABLETABLE_H
@@ -16,17 +17,17 @@ struct VariableInfo {
 class LLVMValueTable
 {
 private:
-    std::vector<std::unordered_map<std::string, VariableInfo>> variables_;
-    std::vector<std::unordered_map<std::string, llvm::Type*>>  types_;
+    std::vector<std::unordered_map<Symbol, VariableInfo>> variables_;
+    std::vector<std::unordered_map<Symbol, llvm::Type*>>  types_;
 
 public:
     LLVMValueTable();
 
-    void insert(std::string, llvm::Value *, llvm::Type*, bool is_pointer = false);
-    void insert_type(std::string, llvm::Type*);
+    void insert(Symbol, llvm::Value *, llvm::Type*, bool is_pointer = false);
+    void insert_type(Symbol, llvm::Type*);
 
-    VariableInfo* lookup(std::string);
-    llvm::Type* lookup_type(std::string);
+    VariableInfo* lookup(Symbol);
+    llvm::Type* lookup_type(Symbol);
 
     void beginScope();
     void endScope();
@@ -18,7 +18,7 @@ void ScopeTable::endScope()
     scopes_.pop_back();
 }
 
-IdentInfo *ScopeTable::lookup(const string &name, bool only_current)
+IdentInfo *ScopeTable::lookup(Symbol name, bool only_current)
 {
 
     if (only_current)
@@ -40,13 +40,13 @@ IdentInfo *ScopeTable::lookup(const string &name, bool only_current)
     return nullptr;
 }
 
-void ScopeTable::insert(const std::string &name, Kind k, Node *node, std::shared_ptr<TypeInfo> type)
+void ScopeTable::insert(Symbol name, Kind k, Node *node, std::shared_ptr<TypeInfo> type)
 {
     assert(current_scope >= 0);
     scopes_[static_cast<size_t>(current_scope)]->insert(name, k, node, type);
 }
 
-std::shared_ptr<TypeInfo> ScopeTable::lookup_field(const string &record_name, const string &field_name)
+std::shared_ptr<TypeInfo> ScopeTable::lookup_field(Symbol record_name, Symbol field_name)
 {
 
     for (int i = current_scope; i >= 0; i--)
@@ -62,7 +62,7 @@ std::shared_ptr<TypeInfo> ScopeTable::lookup_field(const string &record_name, co
     return nullptr;
 }
 
-std::optional<std::map<string, std::shared_ptr<TypeInfo>>> ScopeTable::lookup_record(const string &record_name) {
+const RecordTypeInfo *ScopeTable::lookup_record(Symbol record_name) {
     for (int i = current_scope; i >= 0; i--)
     {
         auto rec = scopes_[static_cast<size_t>(i)]->lookup_record(record_name);
@@ -72,10 +72,10 @@ std::optional<std::map<string, std::shared_ptr<TypeInfo>>> ScopeTable::lookup_re
         }
     }
 
-    return std::nullopt;
+    return nullptr;
 }
 
-std::shared_ptr<TypeInfo> ScopeTable::lookup_type(const string &name) {
+std::shared_ptr<TypeInfo> ScopeTable::lookup_type(Symbol name) {
 
     for(int i = current_scope; i >= 0; i--){
         auto type = scopes_[static_cast<size_t>(i)]->lookup_type(name);
@@ -87,31 +87,31 @@ std::shared_ptr<TypeInfo> ScopeTable::lookup_type(const string &name) {
     return nullptr;
 }
 
-std::shared_ptr<TypeInfo> ScopeTable::insert_type(const string &type_name, TypeTag tag) {
+std::shared_ptr<TypeInfo> ScopeTable::insert_type(Symbol type_name, TypeTag tag) {
     assert(current_scope >= 0);
     return scopes_[static_cast<size_t>(current_scope)]->insert_type(type_name,tag);
 }
 
-std::shared_ptr<TypeInfo> ScopeTable::insert_type(const string &type_name, const string &aliased_type) {
+std::shared_ptr<TypeInfo> ScopeTable::insert_type(Symbol type_name, const string &aliased_type) {
     assert(current_scope >= 0);
     return scopes_[static_cast<size_t>(current_scope)]->insert_type(type_name,aliased_type);
 }
 
-std::shared_ptr<TypeInfo> ScopeTable::insert_type(const string &type_name, std::shared_ptr<TypeInfo> elementType, int dim) {
+std::shared_ptr<TypeInfo> ScopeTable::insert_type(Symbol type_name, std::shared_ptr<TypeInfo> elementType, int dim) {
     assert(current_scope >= 0);
     return scopes_[static_cast<size_t>(current_scope)]->insert_type(type_name,std::move(elementType),dim);
 }
 
-std::shared_ptr<TypeInfo> ScopeTable::insert_type(const string &type_name, std::map<string, std::shared_ptr<TypeInfo>> fields) {
-    return scopes_[static_cast<size_t>(current_scope)]->insert_type(type_name,std::move(fields));
+std::shared_ptr<TypeInfo> ScopeTable::insert_type(Symbol type_name, const field_decls &fields) {
+    return scopes_[static_cast<size_t>(current_scope)]->insert_type(type_name,fields);
 }
 
-std::shared_ptr<TypeInfo> ScopeTable::insert_type(const string &type_name, std::shared_ptr<TypeInfo> pointee_type) {
+std::shared_ptr<TypeInfo> ScopeTable::insert_type(Symbol type_name, std::shared_ptr<TypeInfo> pointee_type) {
     assert(current_scope >= 0);
     return scopes_[static_cast<size_t>(current_scope)]->insert_type(type_name,std::move(pointee_type));
 }
 
-bool ScopeTable::lookup_name(const string &name, bool only_current) {
+bool ScopeTable::lookup_name(Symbol name, bool only_current) {
 
     if(only_current){
         return scopes_[static_cast<size_t>(current_scope)]->lookup_name(name);
@@ -25,19 +25,19 @@ public:
     void beginScope();
     void endScope();
 
-    bool lookup_name(const string& name, bool only_current = false);
-    IdentInfo *lookup(const string &name, bool only_current = false);
-    std::optional<std::map<string, std::shared_ptr<TypeInfo>>> lookup_record(const string &record_name);
-    std::shared_ptr<TypeInfo> lookup_field(const string &record_name, const string &field_name);
-    std::shared_ptr<TypeInfo> lookup_type(const string& name);
-
-    void insert(const string &name, Kind k, Node *node, std::shared_ptr<TypeInfo> type);
-
-    std::shared_ptr<TypeInfo> insert_type(const string &type_name, TypeTag tag);
-    std::shared_ptr<TypeInfo> insert_type(const string &type_name, const string& aliased_type);
-    std::shared_ptr<TypeInfo> insert_type(const string &type_name, std::shared_ptr<TypeInfo> elementType, int dim);
-    std::shared_ptr<TypeInfo> insert_type(const string &type_name,std::map<string, std::shared_ptr<TypeInfo>> fields);
-    std::shared_ptr<TypeInfo> insert_type(const string &type_name, std::shared_ptr<TypeInfo> pointee_type);
+    bool lookup_name(Symbol name, bool only_current = false);
+    IdentInfo *lookup(Symbol name, bool only_current = false);
+    const RecordTypeInfo *lookup_record(Symbol record_name);
+    std::shared_ptr<TypeInfo> lookup_field(Symbol record_name, Symbol field_name);
+    std::shared_ptr<TypeInfo> lookup_type(Symbol name);
+
+    void insert(Symbol name, Kind k, Node *node, std::shared_ptr<TypeInfo> type);
+
+    std::shared_ptr<TypeInfo> insert_type(Symbol type_name, TypeTag tag);
+    std::shared_ptr<TypeInfo> insert_type(Symbol type_name, const string& aliased_type);
+    std::shared_ptr<TypeInfo> insert_type(Symbol type_name, std::shared_ptr<TypeInfo> elementType, int dim);
+    std::shared_ptr<TypeInfo> insert_type(Symbol type_name, const field_decls &fields);
+    std::shared_ptr<TypeInfo> insert_type(Symbol type_name, std::shared_ptr<TypeInfo> pointee_type);
 
 };
 
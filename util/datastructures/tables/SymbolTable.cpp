@@ -6,7 +6,7 @@
 
 #include <utility>
 
-void SymbolTable::insert(const std::string &name, Kind k, Node *node, std::shared_ptr<TypeInfo> type)
+void SymbolTable::insert(Symbol name, Kind k, Node *node, std::shared_ptr<TypeInfo> type)
 {
 
     // Check if already inserted
@@ -18,14 +18,14 @@ void SymbolTable::insert(const std::string &name, Kind k, Node *node, std::share
     identifiers_[name] = IdentInfo(name, k, node, type);
 }
 
-IdentInfo *SymbolTable::lookup(const std::string &name)
+IdentInfo *SymbolTable::lookup(Symbol name)
 {
 
     auto node = identifiers_.find(name);
     return (node != identifiers_.end()) ? &node->second : nullptr;
 }
 
-std::shared_ptr<TypeInfo> SymbolTable::lookup_field(const string &record_name, const string &field_name)
+std::shared_ptr<TypeInfo> SymbolTable::lookup_field(Symbol record_name, Symbol field_name)
 {
     auto record_itr = types_.find(record_name);
     if (record_itr == types_.end())
@@ -33,54 +33,53 @@ std::shared_ptr<TypeInfo> SymbolTable::lookup_field(const string &record_name, c
         return nullptr;
     }
 
-    auto record_type = types_[record_name];
+    auto &record_type = record_itr->second;
     if(record_type->tag != RECORD){
         return nullptr;
     }
 
-    auto field_map = get<RecordTypeInfo>(record_type->extended_info.value()).fields;
-    auto field = field_map.find(field_name);
+    auto field = get<RecordTypeInfo>(record_type->extended_info.value()).field(field_name);
 
-    if (field == field_map.end())
+    if (!field)
     {
         return nullptr;
     }
 
-    return (*field).second;
+    return field->type;
 }
 
-std::optional<std::map<string, std::shared_ptr<TypeInfo>>> SymbolTable::lookup_record(const string &record_name) {
+const RecordTypeInfo *SymbolTable::lookup_record(Symbol record_name) {
     auto record = types_.find(record_name);
     if(record == types_.end()){
-        return std::nullopt;
+        return nullptr;
     }
 
     if(record->second->tag != RECORD){
-        return std::nullopt;
+        return nullptr;
     }
 
-    return get<RecordTypeInfo>(record->second->extended_info.value()).fields;
+    return &get<RecordTypeInfo>(record->second->extended_info.value());
 }
 
-std::shared_ptr<TypeInfo> SymbolTable::insert_type(const string &type_name, TypeTag tag) {
+std::shared_ptr<TypeInfo> SymbolTable::insert_type(Symbol type_name, TypeTag tag) {
     types_[type_name] = std::make_shared<TypeInfo>(type_name,tag);
     return types_[type_name];
 }
 
 // Overload for aliases
-std::shared_ptr<TypeInfo> SymbolTable::insert_type(const string &type_name, const string &aliased_type) {
+std::shared_ptr<TypeInfo> SymbolTable::insert_type(Symbol type_name, const string &aliased_type) {
     types_[type_name] = std::make_shared<TypeInfo>(type_name,ALIAS,AliasTypeInfo(aliased_type));
     return types_[type_name];
 }
 
 // Overload for ArrayTypes
-std::shared_ptr<TypeInfo> SymbolTable::insert_type(const string &type_name, std::shared_ptr<TypeInfo> elementType, int dim) {
+std::shared_ptr<TypeInfo> SymbolTable::insert_type(Symbol type_name, std::shared_ptr<TypeInfo> elementType, int dim) {
     types_[type_name] = std::make_shared<TypeInfo>(type_name,ARRAY,ArrayTypeInfo(std::move(elementType),dim));
     return types_[type_name];
 }
 
 // Overload for RecordTypes
-std::shared_ptr<TypeInfo> SymbolTable::insert_type(const string &type_name,std::map<string, std::shared_ptr<TypeInfo>> fields)
+std::shared_ptr<TypeInfo> SymbolTable::insert_type(Symbol type_name, const field_decls &fields)
 {
     types_[type_name] = std::make_shared<TypeInfo>(type_name,RECORD,RecordTypeInfo(fields));
     return types_[type_name];
@@ -88,13 +87,13 @@ std::shared_ptr<TypeInfo> SymbolTable::insert_type(const string &type_name,std::
 }
 
 // Overload for PointerTypes
-std::shared_ptr<TypeInfo> SymbolTable::insert_type(const string &type_name, std::shared_ptr<TypeInfo> pointee_type){
+std::shared_ptr<TypeInfo> SymbolTable::insert_type(Symbol type_name, std::shared_ptr<TypeInfo> pointee_type){
     types_[type_name] = std::make_shared<TypeInfo>(type_name,POINTER,PointerTypeInfo(std::move(pointee_type)));
     return types_[type_name];
 }
 
 
-std::shared_ptr<TypeInfo> SymbolTable::lookup_type(const string &name) {
+std::shared_ptr<TypeInfo> SymbolTable::lookup_type(Symbol name) {
     if(types_.find(name) != types_.end()){
         return types_[name];
     }
@@ -103,6 +102,6 @@ std::shared_ptr<TypeInfo> SymbolTable::lookup_type(const string &name) {
 }
 
 // Looks if a name either exists in "identifiers" or in "types"
-bool SymbolTable::lookup_name(const string &name) {
+bool SymbolTable::lookup_name(Symbol name) {
     return identifiers_.contains(name) || types_.contains(name);
 }
@@ -12,6 +12,7 @@
 #include <map>
 #include <optional>
 
+#include "util/Symbol.h"
 #include "util/datastructures/ast/Node.h"
 #include "util/datastructures/tables/TypeInfo.hpp"
 
@@ -37,7 +38,7 @@ enum Kind
  */
 struct IdentInfo
 {
-    string name; // Useful since sometimes the name of the identifier may be "lost" along the way, e.g. when tracing
+    Symbol name; // Useful since sometimes the name of the identifier may be "lost" along the way, e.g. when tracing
     Kind kind;
     Node *node;
     std::shared_ptr<TypeInfo> type; // Note: For Procedures we store the return type
@@ -47,25 +48,25 @@ class SymbolTable
 {
 
 private:
-    std::unordered_map<string, IdentInfo> identifiers_;
-    std::unordered_map<string, std::shared_ptr<TypeInfo>> types_;
+    std::unordered_map<Symbol, IdentInfo> identifiers_;
+    std::unordered_map<Symbol, std::shared_ptr<TypeInfo>> types_;
 
 public:
     explicit SymbolTable() = default;
 
-    void insert(const string &name, Kind k, Node *node, std::shared_ptr<TypeInfo> type);
+    void insert(Symbol name, Kind k, Node *node, std::shared_ptr<TypeInfo> type);
 
-    std::shared_ptr<TypeInfo> insert_type(const string &type_name, TypeTag tag);
-    std::shared_ptr<TypeInfo> insert_type(const string &type_name, const string &aliased_type);
-    std::shared_ptr<TypeInfo> insert_type(const string &type_name, std::shared_ptr<TypeInfo> elementType, int dim);
-    std::shared_ptr<TypeInfo> insert_type(const string &type_name,std::map<string, std::shared_ptr<TypeInfo>> fields);
-    std::shared_ptr<TypeInfo> insert_type(const string &type_name, std::shared_ptr<TypeInfo> pointee_type);
+    std::shared_ptr<TypeInfo> insert_type(Symbol type_name, TypeTag tag);
+    std::shared_ptr<TypeInfo> insert_type(Symbol type_name, const string &aliased_type);
+    std::shared_ptr<TypeInfo> insert_type(Symbol type_name, std::shared_ptr<TypeInfo> elementType, int dim);
+    std::shared_ptr<TypeInfo> insert_type(Symbol type_name, const field_decls &fields);
+    std::shared_ptr<TypeInfo> insert_type(Symbol type_name, std::shared_ptr<TypeInfo> pointee_type);
 
-    IdentInfo *lookup(const std::string &name);
-    bool lookup_name(const string& name);
-    std::shared_ptr<TypeInfo> lookup_field(const string &record_name, const string &field_name);
-    std::shared_ptr<TypeInfo> lookup_type(const string& name);
-    std::optional<std::map<string, std::shared_ptr<TypeInfo>>> lookup_record(const string &record_name);
+    IdentInfo *lookup(Symbol name);
+    bool lookup_name(Symbol name);
+    std::shared_ptr<TypeInfo> lookup_field(Symbol record_name, Symbol field_name);
+    std::shared_ptr<TypeInfo> lookup_type(Symbol name);
+    const RecordTypeInfo *lookup_record(Symbol record_name);
 };
 
 #endif // OBERON0C_SYMBOLTABLE_H
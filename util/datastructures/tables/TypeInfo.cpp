@@ -6,11 +6,29 @@
 
 #include <utility>
 
-bool TypeInfo::operator!=(TypeInfo other) {
-    return !(*this == std::move(other));
+RecordTypeInfo::RecordTypeInfo(const field_decls &fields) {
+    fields_.reserve(fields.size());
+    for(auto &[name, type] : fields){
+        auto index = static_cast<unsigned int>(fields_.size());
+        fields_.push_back({name, index, type});
+        indices_.emplace(name, index);
+    }
+}
+
+const std::vector<RecordField> &RecordTypeInfo::fields() const {
+    return fields_;
+}
+
+const RecordField *RecordTypeInfo::field(Symbol name) const {
+    auto itr = indices_.find(name);
+    return (itr == indices_.end())? nullptr : &fields_[itr->second];
+}
+
+bool TypeInfo::operator!=(const TypeInfo &other) const {
+    return !(*this == other);
 }
 
-bool TypeInfo::operator==(TypeInfo other) {
+bool TypeInfo::operator==(const TypeInfo &other) const {
 
     switch(this->tag){
         case BOOLEAN:
@@ -28,6 +46,7 @@ bool TypeInfo::operator==(TypeInfo other) {
         case ALIAS:
             return(other.tag == ALIAS && this->name == other.name);
         case RECORD: // Note that it never really makes sense to compare two different record types
+            return(this == &other);
         case ERROR_TAG:
         case NIL:
         default:
@@ -10,8 +10,14 @@
 #include <vector>
 #include <variant>
 #include <map>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <utility>
 #include <llvm/IR/Type.h>
 
+#include "util/Symbol.h"
+
 // records a "general type category", i.e. whether the type refers to an integer, boolean, array, record, ...
 enum TypeTag
 {
@@ -35,9 +41,30 @@ struct AliasTypeInfo{
     std::string aliased_type;
 };
 
-struct RecordTypeInfo{
-    std::map<std::string, std::shared_ptr<TypeInfo>> fields;
-    explicit RecordTypeInfo(std::map<std::string, std::shared_ptr<TypeInfo>>& fields) : fields(fields){};
+// field names and types of a record in declaration order
+typedef std::vector<std::pair<Symbol, std::shared_ptr<TypeInfo>>> field_decls;
+
+struct RecordField{
+    Symbol name;
+    unsigned int index;     // position in the record, equals the element index of the lowered struct type
+    std::shared_ptr<TypeInfo> type;
+};
+
+// Layout of a record type, computed once when the type is declared and immutable afterwards.
+// Byte offsets depend on the target and are taken from the DataLayout during code generation.
+class RecordTypeInfo{
+
+private:
+    std::vector<RecordField> fields_;
+    std::unordered_map<Symbol, unsigned int> indices_;
+
+public:
+    explicit RecordTypeInfo(const field_decls &fields);
+
+    [[nodiscard]] const std::vector<RecordField> &fields() const;
+
+    // Returns nullptr if the record has no field of that name
+    [[nodiscard]] const RecordField *field(Symbol name) const;
 };
 
 struct ArrayTypeInfo{
@@ -58,8 +85,8 @@ struct TypeInfo {
     TypeTag tag;
     std::optional<ext_info> extended_info = std::nullopt;
 
-    bool operator!=(TypeInfo other);
-    bool operator==(TypeInfo other);
+    bool operator!=(const TypeInfo &other) const;
+    bool operator==(const TypeInfo &other) const;
 
     TypeInfo(std::string  name, TypeTag tag, std::optional<ext_info> = std::nullopt);
 